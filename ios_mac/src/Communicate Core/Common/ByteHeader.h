@@ -11,8 +11,7 @@
 
 @interface ByteHeader : NSObject
 
-@property (assign, readonly, nonatomic) char byte1;
-@property (assign, readonly, nonatomic) char byte2;
+@property (assign, readonly, nonatomic) int32_t identifier;
 
 @property (assign, readonly, nonatomic) CommunicationDataType dataType;
 
@@ -23,7 +22,7 @@
 + (ByteHeader *)otherByteHeader;
 + (ByteHeader *)terminationByteHeader;
 
-- (instancetype)initWithFirstByte:(char)byte1 secondByte:(char)byte2 dataType:(CommunicationDataType)dataType;
+- (instancetype)initWithIdentifier:(int32_t)identifier dataType:(CommunicationDataType)dataType;
 
 - (NSData *)toData;
 
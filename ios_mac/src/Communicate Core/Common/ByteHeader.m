@@ -10,8 +10,7 @@
 
 @interface ByteHeader ()
 
-@property (assign, readwrite, nonatomic) char byte1;
-@property (assign, readwrite, nonatomic) char byte2;
+@property (assign, readwrite, nonatomic) int32_t identifier;
 
 @property (assign, readwrite, nonatomic) CommunicationDataType dataType;
 
@@ -19,37 +18,36 @@
 
 @implementation ByteHeader
 
-- (instancetype)initWithFirstByte:(char)byte1 secondByte:(char)byte2 dataType:(CommunicationDataType)dataType{
+- (instancetype)initWithIdentifier:(int32_t)identifier dataType:(CommunicationDataType)dataType{
     self = [super init];
     if(self) {
-        self.byte1 = byte1;
-        self.byte2 = byte2;
+        self.identifier = identifier;
         self.dataType = dataType;
     }
     return self;
 }
 + (ByteHeader *)stringByteHeader {
-    return [[ByteHeader alloc] initWithFirstByte:0x01 secondByte:0x01 dataType:CommunicationDataTypeString];
+    return [[ByteHeader alloc] initWithIdentifier:1 dataType:CommunicationDataTypeString];
 }
 
 + (ByteHeader *)imageByteHeader {
-    return [[ByteHeader alloc] initWithFirstByte:0x02 secondByte:0x02 dataType:CommunicationDataTypeImage];
+    return [[ByteHeader alloc] initWithIdentifier:2 dataType:CommunicationDataTypeImage];
 }
 
 + (ByteHeader *)fileByteHeader {
-    return [[ByteHeader alloc] initWithFirstByte:0x03 secondByte:0x03 dataType:CommunicationDataTypeFile];
+    return [[ByteHeader alloc] initWithIdentifier:3 dataType:CommunicationDataTypeFile];
 }
 
 + (ByteHeader *)JSONByteHeader {
-    return [[ByteHeader alloc] initWithFirstByte:0x04 secondByte:0x04 dataType:CommunicationDataTypeJSON];
+    return [[ByteHeader alloc] initWithIdentifier:21 dataType:CommunicationDataTypeJSON];
 }
 
 + (ByteHeader *)otherByteHeader {
-    return [[ByteHeader alloc] initWithFirstByte:0x09 secondByte:0x09 dataType:CommunicationDataTypeOther];
+    return [[ByteHeader alloc] initWithIdentifier:99 dataType:CommunicationDataTypeOther];
 }
 
 + (ByteHeader *)terminationByteHeader {
-    return [[ByteHeader alloc] initWithFirstByte:0x00 secondByte:0x00 dataType:CommunicationDataTypeTermination];
+    return [[ByteHeader alloc] initWithIdentifier:0 dataType:CommunicationDataTypeTermination];
 }
 
 - (BOOL)isEqual:(id)object {
@@ -57,7 +55,7 @@
         return NO;
     }
     ByteHeader *otherByterHeader = (ByteHeader *)object;
-    if(otherByterHeader.byte1 == self.byte1 && otherByterHeader.byte2 == self.byte2) {
+    if(otherByterHeader.identifier == self.identifier) {
         return YES;
     }
     
@@ -65,15 +63,12 @@
 }
 
 - (NSData *)toData {
-    NSMutableData *data = [NSMutableData data];
-    char bytesToAppend[2] = { self.byte1, self.byte2 };
-    [data appendBytes:bytesToAppend length:sizeof(bytesToAppend)];
-    
-    return [NSData dataWithData:data];
+    int32_t identifier = CFSwapInt32HostToLittle(self.identifier);
+    return [NSData dataWithBytes:&identifier length:sizeof(identifier)];
 }
 
 - (NSString *)description {
-    return [NSString stringWithFormat:@"Byte Header: first byte = %c; second byte = %c; data type = %ld", self.byte1, self.byte2, (long)self.dataType];
+    return [NSString stringWithFormat:@"Byte Header: identifier = %d; data type = %ld", self.identifier, (long)self.dataType];
 }
 
 @end
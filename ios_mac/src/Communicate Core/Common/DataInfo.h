@@ -20,6 +20,8 @@
 @property (assign, readonly, nonatomic) NSUInteger contentLength;
 @property (assign, readonly, nonatomic) NSUInteger footerLength;
 
+@property (assign, readonly, nonatomic, getter=isValid) BOOL valid;
+
 + (NSUInteger)length;
 
 - (instancetype)initWithDataType:(CommunicationDataType)dataType header:(DataHeader *)header content:(DataContent *)content footer:(DataFooter *)footer;
@@ -14,6 +14,13 @@
 #import "DataFooter.h"
 #import "ByteHeader.h"
 
+static const uint8_t DataInfoMagic = 0xC5;
+static const uint8_t DataInfoVersion = 1;
+
+static const NSUInteger DataInfoMaximumHeaderLength = 64 * 1024;
+static const NSUInteger DataInfoMaximumContentLength = 256 * 1024 * 1024;
+static const NSUInteger DataInfoMaximumFooterLength = 64 * 1024;
+
 @interface DataInfo ()
 
 @property (assign, readwrite, nonatomic) CommunicationDataType dataType;
@@ -21,6 +28,8 @@
 @property (assign, readwrite, nonatomic) NSUInteger contentLength;
 @property (assign, readwrite, nonatomic) NSUInteger footerLength;
 
+@property (assign, readwrite, nonatomic, getter=isValid) BOOL valid;
+
 + (NSArray *)byteHeaders;
 
 @end
@@ -36,6 +45,7 @@
             self.contentLength = [content getData].length;
             self.footerLength = [footer getData].length;
         }
+        self.valid = YES;
     }
     return self;
 }
@@ -43,12 +53,21 @@
 - (instancetype)initWithData:(NSData *)data {
     self = [super init];
     if(self) {
-        self.dataType = [DataInfo dataTypeFromHeaderData:data];
-        if(self.dataType != CommunicationDataTypeTermination) {
-            self.headerLength = [DataInfo headerLengthFromHeaderData:data];
-            self.contentLength = [DataInfo contentLengthFromHeaderData:data];
-            self.footerLength = [DataInfo footerLengthFromHeaderData:data];
+        if(data.length < [DataInfo length]) {
+            return self;
         }
+        
+        const uint8_t *bytes = data.bytes;
+        if(bytes[0] != DataInfoMagic || bytes[1] != DataInfoVersion || bytes[2] != 0 || bytes[3] != 0) {
+            return self;
+        }
+        
+        self.dataType = [DataInfo dataTypeFromHeaderData:data];
+        self.headerLength = [DataInfo headerLengthFromHeaderData:data];
+        self.contentLength = [DataInfo contentLengthFromHeaderData:data];
+        self.footerLength = [DataInfo footerLengthFromHeaderData:data];
+        
+        self.valid = self.headerLength <= DataInfoMaximumHeaderLength && self.contentLength <= DataInfoMaximumContentLength && self.footerLength <= DataInfoMaximumFooterLength;
     }
     return self;
 }
@@ -56,15 +75,17 @@
 - (NSData *)getData {
     NSMutableData *header = [[NSMutableData alloc]init];
     
-    NSUInteger headerLength = self.headerLength;
-    NSUInteger contentLength = self.contentLength;
-    NSUInteger footerLength = self.footerLength;
+    uint8_t prefix[4] = { DataInfoMagic, DataInfoVersion, 0, 0 };
+    int32_t headerLength = CFSwapInt32HostToLittle((int32_t)self.headerLength);
+    int32_t contentLength = CFSwapInt32HostToLittle((int32_t)self.contentLength);
+    int32_t footerLength = CFSwapInt32HostToLittle((int32_t)self.footerLength);
     
     NSData *typeData = [DataInfo typeDataFromDataType:self.dataType];
     NSData *headerLengthData = [NSData dataWithBytes: &headerLength length:4];
     NSData *contentLengthData = [NSData dataWithBytes: &contentLength length:4];
     NSData *footerLengthData = [NSData dataWithBytes: &footerLength length:4];
     
+    [header appendBytes:prefix length:sizeof(prefix)];
     [header appendData:typeData];
     [header appendData:headerLengthData];
     [header appendData:contentLengthData];
@@ -74,32 +95,33 @@
 }
 
 + (NSUInteger)length {
-    return 14;
+    return 20;
 }
 
 + (NSUInteger)headerLengthFromHeaderData:(NSData *)headerData {
-    int bytes;
-    [headerData getBytes:&bytes range:NSMakeRange(2, 4)];
-    return bytes;
+    return [DataInfo lengthFromHeaderData:headerData location:8];
 }
 
 + (NSUInteger)contentLengthFromHeaderData:(NSData *)headerData {
-    int bytes;
-    [headerData getBytes:&bytes range:NSMakeRange(6, 4)];
-    return bytes;
+    return [DataInfo lengthFromHeaderData:headerData location:12];
 }
 
 + (NSUInteger)footerLengthFromHeaderData:(NSData *)headerData {
-    int bytes;
-    [headerData getBytes:&bytes range:NSMakeRange(10, 4)];
-    return bytes;
+    return [DataInfo lengthFromHeaderData:headerData location:16];
+}
+
++ (NSUInteger)lengthFromHeaderData:(NSData *)headerData location:(NSUInteger)location {
+    int32_t bytes;
+    [headerData getBytes:&bytes range:NSMakeRange(location, 4)];
+    bytes = CFSwapInt32LittleToHost(bytes);
+    return bytes < 0 ? NSUIntegerMax : (NSUInteger)bytes;
 }
 
 + (CommunicationDataType)dataTypeFromHeaderData:(NSData *)headerData {
-    char bytes[2];
-    [headerData getBytes:&bytes length:sizeof(bytes)];
+    int32_t identifier;
+    [headerData getBytes:&identifier range:NSMakeRange(4, 4)];
     
-    ByteHeader *byteHeader = [[ByteHeader alloc]initWithFirstByte:bytes[0] secondByte:bytes[1] dataType:CommunicationDataTypeOther];
+    ByteHeader *byteHeader = [[ByteHeader alloc]initWithIdentifier:CFSwapInt32LittleToHost(identifier) dataType:CommunicationDataTypeOther];
     ByteHeader *actualByteHeader = [ByteHeader otherByteHeader];
     
     for (ByteHeader *aByteHeader in [DataInfo byteHeaders]) {
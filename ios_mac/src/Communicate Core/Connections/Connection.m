@@ -185,13 +185,9 @@
         }
     }
     else if(eventCode == NSStreamEventHasBytesAvailable) {
-        NSUInteger infoLength = [DataInfo length];
-        
-        uint8_t infoBuffer[infoLength];
-        [self.inputStream read:infoBuffer maxLength:infoLength];
-        NSData *infoData = [[NSData alloc]initWithBytes:(const void *)infoBuffer length:infoLength];
+        NSData *infoData = [self read:[DataInfo length] callback:nil];
         DataInfo *dataInfo = [[DataInfo alloc]initWithData:infoData];
-        if(dataInfo.dataType == CommunicationDataTypeTermination) {
+        if(!dataInfo.isValid || dataInfo.dataType == CommunicationDataTypeTermination) {
             [self disconnect:NO];
             return;
         }
@@ -239,9 +235,9 @@
         NSInteger maxPacketSize = MIN(length, 4096);
         NSInteger bytesRead = 0;
         
+        uint8_t buffer[maxPacketSize];
         while (bytesRead < length) {
-            uint8_t buffer[maxPacketSize];
-            NSInteger readResult = [self.inputStream read:buffer maxLength:maxPacketSize];
+            NSInteger readResult = [self.inputStream read:buffer maxLength:MIN(length - bytesRead, maxPacketSize)];
             if(readResult > 0) {
                 bytesRead += readResult;
                 [data appendBytes:buffer length:readResult];
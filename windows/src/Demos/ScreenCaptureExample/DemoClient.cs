@@ -41,6 +41,7 @@ private void DemoClient_Load(object sender, EventArgs e)
                 var connection = eventArgs.ActiveConnection;
                 if (connection.State == ConnectionState.Connected)
                 {
+                    connection.OpenDatagramChannel();
                     TakingScreenshots = true;
                     BackgroundThread = new Thread(Screenshot) {IsBackground = true};
                     BackgroundThread.Start();
@@ -71,7 +72,7 @@ private void Screenshot()
                             bmpScreenCapture.Size,
                             CopyPixelOperation.SourceCopy);
                     }
-                    Client.SendData(new CommunicationData().WithImage(bmpScreenCapture), null);
+                    Client.SendDatagram(new CommunicationData().WithImage(bmpScreenCapture), null);
                 }
                 Thread.Sleep(Convert.ToInt32(1000/15.0));
             }
@@ -1,4 +1,5 @@
 ﻿using System;
+using System.Collections.Concurrent;
 using System.Collections.ObjectModel;
 using System.Net;
 using System.Net.Sockets;
@@ -34,6 +35,60 @@ public void SetTxtRecords(Collection<TxtRecord> txtRecords)
         {
             TxtRecords = txtRecords;
         }
+
+        public ContentCache ContentCache { get; private set; }
+
+        public void SetContentCache(ContentCache contentCache)
+        {
+            ContentCache = contentCache;
+            Connections.PerformActionOnAll(connection => connection.SetContentCache(contentCache));
+        }
+
+        public FrameLimits FrameLimits { get; private set; } = new FrameLimits();
+
+        public void SetFrameLimits(FrameLimits frameLimits)
+        {
+            if (frameLimits == null)
+            {
+                throw new ArgumentNullException(nameof(frameLimits));
+            }
+            FrameLimits = frameLimits;
+            Connections.PerformActionOnAll(connection => connection.SetFrameLimits(frameLimits));
+        }
+
+        public long BandwidthLimit => SendBucket.BytesPerSecond;
+        public TimeSpan ThrottledTime => SendBucket.ThrottledTime;
+
+        private TokenBucket SendBucket { get; } = new TokenBucket();
+
+        public TrafficRecorder TrafficRecorder { get; private set; }
+
+        public void SetTrafficRecorder(TrafficRecorder trafficRecorder)
+        {
+            TrafficRecorder = trafficRecorder;
+            Connections.PerformActionOnAll(connection => connection.SetTrafficRecorder(trafficRecorder));
+        }
+
+        public int EncodePipelineDepth { get; private set; }
+
+        public void SetEncodePipelineDepth(int encodePipelineDepth)
+        {
+            if (encodePipelineDepth < 0 || encodePipelineDepth > EncodePipeline.MaximumDepth)
+            {
+                throw new ArgumentOutOfRangeException(nameof(encodePipelineDepth), encodePipelineDepth, "The value for this property must be between 0 and " + EncodePipeline.MaximumDepth);
+            }
+            EncodePipelineDepth = encodePipelineDepth;
+            Connections.PerformActionOnAll(connection => connection.SetEncodePipelineDepth(encodePipelineDepth));
+        }
+
+        public void SetBandwidthLimit(long bandwidthLimit)
+        {
+            if (bandwidthLimit < 0)
+            {
+                throw new ArgumentOutOfRangeException(nameof(bandwidthLimit), bandwidthLimit, "The value for this property must not be negative");
+            }
+            SendBucket.SetBytesPerSecond(bandwidthLimit);
+        }
         
         public event EventHandler DidUpdatePublishedState;
 
@@ -60,10 +115,44 @@ public void SetTxtRecords(Collection<TxtRecord> txtRecords)
         public Collection<Connection> DiscoveredServices { get; } = new Collection<Connection>();
 
         public ConnectionCollection Connections { get; } = new ConnectionCollection();
+        private TopicIndex Topics { get; } = new TopicIndex();
+
+        public bool RelayEnabled { get; private set; }
+        private ConcurrentDictionary<Guid, Connection> RelayRoutes { get; } = new ConcurrentDictionary<Guid, Connection>();
+
+        public void SetRelayEnabled(bool relayEnabled)
+        {
+            RelayEnabled = relayEnabled;
+        }
+
+        private Connection RelayRouteForDestination(Guid destination)
+        {
+            Connection connection;
+            return RelayEnabled && RelayRoutes.TryGetValue(destination, out connection) ? connection : null;
+        }
+
+        private void RegisterRelayRoute(Guid destination, Connection connection)
+        {
+            RelayRoutes.AddOrUpdate(destination, connection, (key, existingConnection) =>
+                ReferenceEquals(existingConnection, connection) || existingConnection.State != ConnectionState.Connected ? connection : existingConnection);
+        }
+
+        private void RemoveRelayRoutes(Connection connection)
+        {
+            foreach (var route in RelayRoutes)
+            {
+                if (ReferenceEquals(route.Value, connection))
+                {
+                    Connection removedConnection;
+                    RelayRoutes.TryRemove(route.Key, out removedConnection);
+                }
+            }
+        }
 
         public State ListeningState { get; private set; } = State.Ready;
         public CommunicatorException ListeningException { get; private set; }
         private TcpListener ConnectionListener { get; set; }
+        private Socket LocalConnectionListener { get; set; }
 
         public void Dispose()
         {
@@ -80,6 +169,8 @@ protected virtual void Dispose(bool disposing)
                     ConnectionListener.Stop();
                     ConnectionListener = null;
                 }
+                UnixDomainTransport.StopListening(LocalConnectionListener, Information.Port);
+                LocalConnectionListener = null;
             }
         }
 
@@ -231,11 +322,17 @@ protected void HandleStartListening()
         {
             ConnectionListener.Start();
             ConnectionListener.BeginAcceptSocket(AcceptSocketCallback, ConnectionListener);
+
+            LocalConnectionListener = UnixDomainTransport.Listen(Information.Port);
+            LocalConnectionListener?.BeginAccept(AcceptLocalSocketCallback, LocalConnectionListener);
         }
 
         protected void HandleStopListening()
         {
             ConnectionListener.Stop();
+
+            UnixDomainTransport.StopListening(LocalConnectionListener, Information.Port);
+            LocalConnectionListener = null;
         }
 
         public void StartListeningForConnections()
@@ -283,7 +380,7 @@ private void AcceptSocketCallback(IAsyncResult asyncResult)
             var listener = (TcpListener)asyncResult.AsyncState;
             try
             {
-                ConnectTo(listener.EndAcceptSocket(asyncResult));
+                ConnectTo(listener.EndAcceptSocket(asyncResult), true);
             }
             catch (SocketException)
             {
@@ -294,14 +391,68 @@ private void AcceptSocketCallback(IAsyncResult asyncResult)
             }
         }
 
+        private void AcceptLocalSocketCallback(IAsyncResult asyncResult)
+        {
+            var listener = (Socket)asyncResult.AsyncState;
+            try
+            {
+                ConnectTo(listener.EndAccept(asyncResult), true);
+            }
+            catch (SocketException)
+            {
+            }
+            catch (ObjectDisposedException)
+            {
+            }
+            finally
+            {
+                try
+                {
+                    listener.BeginAccept(AcceptLocalSocketCallback, listener);
+                }
+                catch (ObjectDisposedException)
+                {
+                }
+            }
+        }
+
         public void ConnectTo(Socket socket)
+        {
+            ConnectTo(socket, true);
+        }
+
+        public void ConnectTo(Socket socket, bool accepted)
         {
             if (socket == null)
             {
                 throw new ArgumentNullException(nameof(socket));
             }
 
-            ConnectTo(new Connection(socket));
+            ConnectTo(new Connection(socket, accepted));
+        }
+
+        public void ConnectTo(ConnectionTransport transport, bool accepted)
+        {
+            if (transport == null)
+            {
+                throw new ArgumentNullException(nameof(transport));
+            }
+
+            ConnectTo(new Connection(transport, accepted));
+        }
+
+        public void ConnectInMemory(BaseCommunicator communicator, LinkConditions conditions)
+        {
+            if (communicator == null)
+            {
+                throw new ArgumentNullException(nameof(communicator));
+            }
+
+            MemoryTransport client;
+            MemoryTransport server;
+            MemoryTransport.CreatePair(conditions ?? new LinkConditions(), out client, out server);
+            communicator.ConnectTo(server, true);
+            ConnectTo(client, false);
         }
 
         public void ConnectTo(IPAddress address, int port)
@@ -332,7 +483,7 @@ public void ConnectTo(Connection connection)
             {
                 throw new ArgumentNullException(nameof(connection));
             }
-            if (Connections.Contains(connection))
+            if (Connections.Contains(connection) || (connection.Information?.EndPoint != null && Connections.Find(connection.Information.EndPoint) != null))
             {
                 return;
             }
@@ -352,20 +503,28 @@ public void ConnectTo(Connection connection)
 
         private void SetupConnection(Connection connection)
         {
+            connection.SetContentCache(ContentCache);
+            connection.SetFrameLimits(FrameLimits);
+            connection.SetTlsSettings(Information.TlsSettings);
+            connection.SetEncodePipelineDepth(EncodePipelineDepth);
+            connection.SetTrafficRecorder(TrafficRecorder);
+            connection.SharedSendBucket = SendBucket;
+
             connection.DidUpdateState += (baseConnection, eventArgs) =>
             {
-                if (Connections.Contains(connection) && (connection.State == ConnectionState.Connected || connection.State == ConnectionState.Connecting))
+                if (connection.State == ConnectionState.Connected && !Connections.Add(connection))
                 {
                     return;
                 }
-
-                if (connection.State == ConnectionState.Connected)
+                if (connection.State == ConnectionState.Connecting && Connections.Contains(connection))
                 {
-                    Connections.Add(connection);
+                    return;
                 }
-                else if (connection.State == ConnectionState.Disconnected && Connections.Contains(connection))
+
+                if (connection.State == ConnectionState.Disconnected && Connections.Remove(connection))
                 {
-                    Connections.Remove(connection);
+                    Topics.RemoveConnection(connection);
+                    RemoveRelayRoutes(connection);
                 }
 
                 DidUpdateConnectionState?.Invoke(this, new ConnectionEventArgs(connection));
@@ -391,6 +550,21 @@ private void SetupConnection(Connection connection)
                 DidUpdateReceivingData?.Invoke(this, eventArgs);
             };
 
+            connection.RelayRouter = RelayRouteForDestination;
+            connection.DidRegisterRoute += (delegateConnection, routeArgs) => RegisterRelayRoute(routeArgs.Destination, connection);
+
+            connection.DidUpdateSubscription += (delegateConnection, topicArgs) =>
+            {
+                if (topicArgs.Subscribed)
+                {
+                    Topics.Subscribe(connection, topicArgs.Topic);
+                }
+                else
+                {
+                    Topics.Unsubscribe(connection, topicArgs.Topic);
+                }
+            };
+
             connection.DidUpdateSendingData += (delegateConnection, dataArgs) =>
             {
                 var eventArgs = new ConnectionEventArgs(connection, dataArgs.Data,
@@ -411,6 +585,75 @@ public void SendData(CommunicationData data, Connection connection)
             }
         }
 
+        public void SendData(Func<CommunicationData> encode, Connection connection)
+        {
+            if (encode == null)
+            {
+                throw new ArgumentNullException(nameof(encode));
+            }
+
+            if (connection != null)
+            {
+                connection.Send(encode);
+            }
+            else
+            {
+                var data = new Lazy<CommunicationData>(encode);
+                Connections.PerformActionOnAll(eachConnection => eachConnection.Send(() => data.Value));
+            }
+        }
+
+        public void Publish(string topic, CommunicationData data)
+        {
+            if (data == null)
+            {
+                throw new ArgumentNullException(nameof(data));
+            }
+            TopicIndex.ValidateTopic(topic, false);
+
+            data.WithHeader(TopicIndex.TopicKey, topic);
+            foreach (var connection in Topics.ConnectionsForTopic(topic))
+            {
+                connection.Send(data);
+            }
+        }
+
+        public void Subscribe(string topic, Connection connection)
+        {
+            if (connection != null)
+            {
+                connection.Subscribe(topic);
+            }
+            else
+            {
+                Connections.PerformActionOnAll(eachConnection => eachConnection.Subscribe(topic));
+            }
+        }
+
+        public void Unsubscribe(string topic, Connection connection)
+        {
+            if (connection != null)
+            {
+                connection.Unsubscribe(topic);
+            }
+            else
+            {
+                Connections.PerformActionOnAll(eachConnection => eachConnection.Unsubscribe(topic));
+            }
+        }
+
+        public void SendDatagram(CommunicationData data, Connection connection)
+        {
+            if (connection != null)
+            {
+                connection.SendDatagram(data);
+            }
+            else
+            {
+                Connections.SendDatagramToAll(data);
+            }
+        }
+
         public abstract string SerializeProtocolType();
     }
 }
\ No newline at end of file
@@ -16,5 +16,12 @@ public CommunicatorInformation(int port, string name)
 
         public string Name { get; }
         public int Port { get; }
+
+        public TlsSettings TlsSettings { get; private set; }
+
+        public void SetTlsSettings(TlsSettings tlsSettings)
+        {
+            TlsSettings = tlsSettings;
+        }
     }
 }
\ No newline at end of file
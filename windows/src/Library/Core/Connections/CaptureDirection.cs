@@ -0,0 +1,8 @@
+﻿namespace Communicate
+{
+    public enum CaptureDirection
+    {
+        Sent,
+        Received
+    }
+}
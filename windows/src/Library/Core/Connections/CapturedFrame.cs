@@ -0,0 +1,18 @@
+﻿using System;
+
+namespace Communicate
+{
+    public class CapturedFrame
+    {
+        internal CapturedFrame(DateTime timestamp, CaptureDirection direction, CommunicationData data)
+        {
+            Timestamp = timestamp;
+            Direction = direction;
+            Data = data;
+        }
+
+        public DateTime Timestamp { get; }
+        public CaptureDirection Direction { get; }
+        public CommunicationData Data { get; }
+    }
+}
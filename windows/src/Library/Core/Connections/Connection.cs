@@ -1,7 +1,7 @@
 ﻿using System;
 using System.Collections.Generic;
 using System.Collections.ObjectModel;
-using System.Linq;
+using System.IO;
 using System.Net;
 using System.Net.Sockets;
 using System.Threading;
@@ -10,14 +10,29 @@ namespace Communicate
 {
     public class Connection : IEquatable<Connection>
     {
-        protected internal Connection(Socket socket)
+        private const int RelayBufferSize = 64*1024;
+        private const int BandwidthQuantum = 8*1024;
+        private const int MaximumBandwidthWeight = 16;
+        private const int MaximumPendingTransfers = 16;
+        private const int MaximumQueriedContents = 16;
+
+        protected internal Connection(Socket socket) : this(socket, true)
+        {
+        }
+
+        protected internal Connection(Socket socket, bool accepted) : this(new SocketTransport(socket), accepted)
         {
-            if (socket == null)
+        }
+
+        protected internal Connection(ConnectionTransport transport, bool accepted)
+        {
+            if (transport == null)
             {
-                throw new ArgumentNullException(nameof(socket));
+                throw new ArgumentNullException(nameof(transport));
             }
-            ConnectionSocket = socket;
-            Information = new ConnectionInformation((IPEndPoint)socket.RemoteEndPoint);
+            Transport = transport;
+            Information = new ConnectionInformation(transport.RemoteEndPoint as IPEndPoint ?? new IPEndPoint(IPAddress.Loopback, 0));
+            Accepted = accepted;
         }
 
         protected internal Connection(IPEndPoint endPoint)
@@ -33,12 +48,33 @@ protected internal Connection()
         {
         }
 
+        public Guid Identifier { get; } = Guid.NewGuid();
         public ConnectionState State { get; private set; } = ConnectionState.NotConnected;
         public CommunicatorException ConnectionException { get; private set; }
 
         public ConnectionInformation Information { get; private set; } = new ConnectionInformation();
 
-        protected Socket ConnectionSocket { get; private set; }
+        private ConnectionTransport activeTransport;
+
+        protected ConnectionTransport Transport
+        {
+            get { return activeTransport; }
+            private set { activeTransport = value; }
+        }
+
+        private ConnectionTransport ConnectedTransport
+        {
+            get
+            {
+                var transport = activeTransport;
+                if (transport == null)
+                {
+                    throw new CommunicatorException(CommunicatorErrorCode.ConnectionClosed, null);
+                }
+                return transport;
+            }
+        }
+        private bool Accepted { get; }
         private Thread BackgroundThread { get; set; }
 
         internal byte[] TxtRecordsData { get; private set; }
@@ -76,6 +112,125 @@ public void SetSendingUpdatePercentage(int sendingUpdatePercentage)
             SendingUpdatePercentage = sendingUpdatePercentage;
         }
 
+        public int ParallelStreamCount { get; private set; } = 1;
+        public int ParallelTransferThreshold { get; private set; } = 4*1024*1024;
+
+        public void SetParallelStreamCount(int parallelStreamCount)
+        {
+            if (parallelStreamCount < 1 || parallelStreamCount > ParallelTransfer.MaximumStreamCount)
+            {
+                throw new ArgumentOutOfRangeException(nameof(parallelStreamCount), parallelStreamCount, "The value for this property must be between 1 and " + ParallelTransfer.MaximumStreamCount);
+            }
+            ParallelStreamCount = parallelStreamCount;
+        }
+
+        public void SetParallelTransferThreshold(int parallelTransferThreshold)
+        {
+            if (parallelTransferThreshold < 0)
+            {
+                throw new ArgumentOutOfRangeException(nameof(parallelTransferThreshold), parallelTransferThreshold, "The value for this property must not be negative");
+            }
+            ParallelTransferThreshold = parallelTransferThreshold;
+        }
+
+        public ContentCache ContentCache { get; private set; }
+
+        public void SetContentCache(ContentCache contentCache)
+        {
+            ContentCache = contentCache;
+        }
+
+        public FrameLimits FrameLimits { get; private set; } = new FrameLimits();
+
+        public void SetFrameLimits(FrameLimits frameLimits)
+        {
+            if (frameLimits == null)
+            {
+                throw new ArgumentNullException(nameof(frameLimits));
+            }
+            FrameLimits = frameLimits;
+            if (DatagramChannel != null)
+            {
+                DatagramChannel.FrameLimits = frameLimits;
+            }
+        }
+
+        public TlsSettings TlsSettings { get; private set; }
+
+        public void SetTlsSettings(TlsSettings tlsSettings)
+        {
+            TlsSettings = tlsSettings;
+        }
+
+        public long BandwidthLimit => SendBucket.BytesPerSecond;
+        public int BandwidthWeight { get; private set; } = 1;
+        public TimeSpan ThrottledTime => TimeSpan.FromTicks(Interlocked.Read(ref throttledTicks));
+
+        public void SetBandwidthLimit(long bandwidthLimit)
+        {
+            if (bandwidthLimit < 0)
+            {
+                throw new ArgumentOutOfRangeException(nameof(bandwidthLimit), bandwidthLimit, "The value for this property must not be negative");
+            }
+            SendBucket.SetBytesPerSecond(bandwidthLimit);
+        }
+
+        public void SetBandwidthWeight(int bandwidthWeight)
+        {
+            if (bandwidthWeight < 1 || bandwidthWeight > MaximumBandwidthWeight)
+            {
+                throw new ArgumentOutOfRangeException(nameof(bandwidthWeight), bandwidthWeight, "The value for this property must be between 1 and " + MaximumBandwidthWeight);
+            }
+            BandwidthWeight = bandwidthWeight;
+        }
+
+        private TokenBucket SendBucket { get; } = new TokenBucket();
+        internal TokenBucket SharedSendBucket { get; set; }
+        private long throttledTicks;
+
+        private bool IsSendShaped => SendBucket.BytesPerSecond > 0 || SharedSendBucket?.BytesPerSecond > 0;
+
+        public int EncodePipelineDepth { get; private set; }
+
+        public void SetEncodePipelineDepth(int encodePipelineDepth)
+        {
+            if (encodePipelineDepth < 0 || encodePipelineDepth > EncodePipeline.MaximumDepth)
+            {
+                throw new ArgumentOutOfRangeException(nameof(encodePipelineDepth), encodePipelineDepth, "The value for this property must be between 0 and " + EncodePipeline.MaximumDepth);
+            }
+            lock (EncodeLock)
+            {
+                EncodePipelineDepth = encodePipelineDepth;
+                if (EncodePipeline != null)
+                {
+                    EncodePipeline.Depth = encodePipelineDepth;
+                }
+            }
+        }
+
+        private EncodePipeline EncodePipeline { get; set; }
+
+        public TrafficRecorder TrafficRecorder { get; private set; }
+
+        public void SetTrafficRecorder(TrafficRecorder trafficRecorder)
+        {
+            TrafficRecorder = trafficRecorder;
+        }
+
+        public DatagramChannel DatagramChannel { get; private set; }
+
+        private byte[] FrameHeaderBuffer { get; } = new byte[FrameHeader.MaximumSize];
+        private byte[] RelayBuffer { get; set; }
+
+        internal Func<Guid, Connection> RelayRouter { get; set; }
+
+        private object SendLock { get; } = new object();
+        private object DatagramLock { get; } = new object();
+        private object EncodeLock { get; } = new object();
+        private List<PendingReply> PendingReplies { get; } = new List<PendingReply>();
+        private Dictionary<Guid, TcpListener> PendingTransfers { get; } = new Dictionary<Guid, TcpListener>();
+        private Dictionary<string, byte[]> QueriedContents { get; } = new Dictionary<string, byte[]>();
+
         protected internal event EventHandler DidUpdateState;
         protected internal event EventHandler DidUpdateTxtRecords;
         protected internal event EventHandler DidUpdateInformation;
@@ -84,6 +239,9 @@ public void SetSendingUpdatePercentage(int sendingUpdatePercentage)
 
         protected internal event EventHandler<ConnectionDataEventArgs> DidUpdateSendingData;
 
+        internal event EventHandler<TopicEventArgs> DidUpdateSubscription;
+        internal event EventHandler<RouteEventArgs> DidRegisterRoute;
+
         protected void UpdateState(ConnectionState newState)
         {
             if (State == newState)
@@ -124,9 +282,7 @@ internal void Resolve()
                 Information.SetEndPoint(endPoint);
                 UpdateState(ConnectionState.Resolved);
 
-                ConnectionSocket = new Socket(AddressFamily.InterNetwork, SocketType.Stream, ProtocolType.Tcp);
-                ConnectionSocket.Connect(Information.EndPoint);
-                ConnectToSocket(ConnectionSocket);
+                ConnectToTransport(SocketTransport.Connect(Information.EndPoint));
             });
         }
 
@@ -156,13 +312,7 @@ internal void Connect()
                 }
                 else
                 {
-                    if (ConnectionSocket == null)
-                    {
-                        ConnectionSocket = new Socket(AddressFamily.InterNetwork, SocketType.Stream, ProtocolType.Tcp);
-                        ConnectionSocket.Connect(Information.EndPoint);
-                    }
-
-                    ConnectToSocket(ConnectionSocket);
+                    ConnectToTransport(Transport ?? SocketTransport.Connect(Information.EndPoint));
                 }
             }
             catch (ObjectDisposedException exception)
@@ -177,15 +327,19 @@ internal void Connect()
 
         protected void ConnectToSocket(Socket socket)
         {
-            if (socket != null && socket.Connected)
-            {
-                ConnectionSocket = socket;
-                Information.SetEndPoint((IPEndPoint)ConnectionSocket.RemoteEndPoint);
-
-                BackgroundThread = new Thread(Receive) { IsBackground = true };
-                BackgroundThread.Start();
+            ConnectToTransport(socket != null ? new SocketTransport(socket) : null);
+        }
 
-                UpdateState(ConnectionState.Connected);
+        protected void ConnectToTransport(ConnectionTransport transport)
+        {
+            if (transport != null && transport.Connected)
+            {
+                if (TlsSettings != null)
+                {
+                    new Thread(() => AuthenticateTransport(transport, TlsSettings)) { IsBackground = true }.Start();
+                    return;
+                }
+                StartTransport(transport);
             }
             else
             {
@@ -193,6 +347,34 @@ protected void ConnectToSocket(Socket socket)
             }
         }
 
+        private void AuthenticateTransport(ConnectionTransport transport, TlsSettings tlsSettings)
+        {
+            try
+            {
+                StartTransport(TlsTransport.Authenticate(transport, tlsSettings, Accepted));
+            }
+            catch (Exception exception)
+            {
+                transport.Close();
+                HandleException(CommunicatorErrorCode.ConnectionAuthenticationFailed, exception);
+            }
+        }
+
+        private void StartTransport(ConnectionTransport transport)
+        {
+            Transport = new ShapedTransport(transport, ReserveSendBandwidth, RefundSendBandwidth, () => IsSendShaped);
+            var endPoint = Transport.RemoteEndPoint as IPEndPoint;
+            if (endPoint != null)
+            {
+                Information.SetEndPoint(endPoint);
+            }
+
+            BackgroundThread = new Thread(Receive) { IsBackground = true };
+            BackgroundThread.Start();
+
+            UpdateState(ConnectionState.Connected);
+        }
+
         protected void SetTxtRecordsData(byte[] txtRecordsData)
         {
             TxtRecordsData = txtRecordsData;
@@ -216,14 +398,31 @@ public void Disconnect(bool disconnectImmediately)
                 Send(new CommunicationData(DataType.Termination));
                 return;
             }
-            ConnectionSocket.Close();
-            ConnectionSocket = null;
+            var transport = Interlocked.Exchange(ref activeTransport, null);
+            if (transport == null)
+            {
+                return;
+            }
+            transport.Close();
+            DatagramChannel?.Close();
+            lock (PendingTransfers)
+            {
+                foreach (var listener in PendingTransfers.Values)
+                {
+                    listener.Stop();
+                }
+                PendingTransfers.Clear();
+            }
+            lock (QueriedContents)
+            {
+                QueriedContents.Clear();
+            }
             UpdateState(ConnectionState.Disconnected);
         }
 
         private void Receive()
         {
-            while (ConnectionSocket?.Connected ?? false)
+            while (Transport?.Connected ?? false)
             {
                 try
                 {
@@ -231,8 +430,21 @@ private void Receive()
                 }
                 catch (SocketException)
                 {
-                    if (ConnectionSocket != null && !ConnectionSocket.Connected)
+                    var transport = Transport;
+                    if (transport != null && !transport.Connected)
+                    {
+                        Disconnect(true);
+                    }
+                }
+                catch (ObjectDisposedException)
+                {
+                    Disconnect(true);
+                }
+                catch (CommunicatorException exception)
+                {
+                    if (Transport != null)
                     {
+                        HandleException(exception.ErrorCode, exception.InnerException);
                         Disconnect(true);
                     }
                 }
@@ -256,10 +468,10 @@ private void ReceiveSocketData(int numberOfBytes, int updatePercentage, Action<b
             {
                 var maxLengthToRead = Math.Min(data.Length - bytesRead, updateBytesFrequency);
 
-                var read = ConnectionSocket.Receive(data, bytesRead, maxLengthToRead, SocketFlags.None);
+                var read = ConnectedTransport.Receive(data, bytesRead, maxLengthToRead);
                 if (read <= 0)
                 {
-                    continue;
+                    throw new CommunicatorException(CommunicatorErrorCode.ConnectionClosed, null);
                 }
                 bytesRead += read;
 
@@ -269,35 +481,128 @@ private void ReceiveSocketData(int numberOfBytes, int updatePercentage, Action<b
             }
         }
 
+        private void ReceiveExactly(byte[] buffer, int offset, int count)
+        {
+            var bytesRead = 0;
+            while (bytesRead < count)
+            {
+                var read = ConnectedTransport.Receive(buffer, offset + bytesRead, count - bytesRead);
+                if (read <= 0)
+                {
+                    throw new CommunicatorException(CommunicatorErrorCode.ConnectionClosed, null);
+                }
+                bytesRead += read;
+            }
+        }
+
+        private FrameHeader ReceiveFrameHeader()
+        {
+            ReceiveExactly(FrameHeaderBuffer, 0, FrameHeader.Size);
+
+            FrameHeader frameHeader;
+            if (!FrameHeader.TryRead(FrameHeaderBuffer, 0, out frameHeader) || !FrameLimits.Allows(frameHeader))
+            {
+                throw new CommunicatorException(CommunicatorErrorCode.ConnectionInvalidFrame, null);
+            }
+            if (frameHeader.HasDestination)
+            {
+                ReceiveExactly(FrameHeaderBuffer, FrameHeader.Size, FrameHeader.DestinationSize);
+                frameHeader = frameHeader.WithDestination(FrameHeaderBuffer, FrameHeader.Size);
+            }
+            return frameHeader;
+        }
+
         private void ReceiveData()
         {
-            ReceiveSocketData(DataInfo.DataInfoSize, 100, (bytes, progress, completed) =>
+            var frameHeader = ReceiveFrameHeader();
+            var relayConnection = frameHeader.HasDestination ? RelayRouter?.Invoke(frameHeader.Destination) : null;
+            if (relayConnection != null && relayConnection != this)
             {
-                var dataInfo = new DataInfo(bytes);
-                var data = new CommunicationData(dataInfo);
+                RelayData(frameHeader, relayConnection);
+                return;
+            }
 
-                DidUpdateReceivingData?.Invoke(this,
-                    new ConnectionDataEventArgs(data, DataComponent.All, ActionState.Started, 0));
+            var data = new CommunicationData(new DataInfo(frameHeader));
+
+            DidUpdateReceivingData?.Invoke(this,
+                new ConnectionDataEventArgs(data, DataComponent.All, ActionState.Started, 0));
 
-                ReceiveDataHeader(data);
-                ReceiveDataContent(data);
-                ReceiveDataFooter(data);
+            ReceiveDataHeader(data);
 
-                if (data.DataType == DataType.Termination)
+            var contentHash = !data.DataType.IsControl ? data.Header.ValueForKey(ContentCache.HashKey) : null;
+            var cachedContent = contentHash != null ? TakeQueriedContent(data.Header.ValueForKey(ContentCache.QueryKey)) : null;
+            if (cachedContent != null && cachedContent.Length == data.Info.ContentLength)
+            {
+                data.InternalContent = cachedContent;
+                DidUpdateReceivingData?.Invoke(this,
+                    new ConnectionDataEventArgs(data, DataComponent.Content, ActionState.Completed, 1));
+            }
+            else
+            {
+                var transfer = ParallelTransfer.FromHeader(data.Header);
+                var listener = transfer != null ? TakePendingTransfer(transfer.Identifier) : null;
+                if (listener != null)
                 {
-                    Disconnect(true);
-                    return;
+                    ReceiveParallelDataContent(data, transfer, listener);
                 }
-                if (data.DataType == DataType.ConnectionInformation)
+                else
                 {
-                    Information = (ConnectionInformation)Serialization.InformationSerializer.FromData(data.GetData());
-                    DidUpdateInformation?.Invoke(this, EventArgs.Empty);
-                    return;
+                    ReceiveDataContent(data);
                 }
 
-                DidUpdateReceivingData?.Invoke(this,
-                    new ConnectionDataEventArgs(data, DataComponent.All, ActionState.Completed, 1));
-            });
+                if (contentHash != null && ContentCache != null && ContentCache.ComputeHash(data.GetData()) == contentHash)
+                {
+                    ContentCache?.Add(contentHash, data.GetData());
+                }
+            }
+
+            ReceiveDataFooter(data);
+            TrafficRecorder?.Record(CaptureDirection.Received, data.Info, data.Header.GetData(), data.GetData(), data.Footer.GetData());
+
+            if (data.DataType == DataType.Termination)
+            {
+                Disconnect(true);
+                return;
+            }
+            if (data.DataType == DataType.ConnectionInformation)
+            {
+                Information = (ConnectionInformation)Serialization.InformationSerializer.FromData(data.GetData());
+                DidUpdateInformation?.Invoke(this, EventArgs.Empty);
+                return;
+            }
+            if (data.DataType == DataType.TransferRequest)
+            {
+                ReceiveTransferRequest(data);
+                return;
+            }
+            if (data.DataType == DataType.ContentQuery)
+            {
+                ReceiveContentQuery(data);
+                return;
+            }
+            if (data.DataType == DataType.TransferAccept || data.DataType == DataType.ContentReply)
+            {
+                CompleteReply(data);
+                return;
+            }
+            if (data.DataType == DataType.DatagramChannel)
+            {
+                ReceiveDatagramChannel(data);
+                return;
+            }
+            if (data.DataType == DataType.Subscribe || data.DataType == DataType.Unsubscribe)
+            {
+                ReceiveSubscription(data);
+                return;
+            }
+            if (data.DataType == DataType.RelayRoute)
+            {
+                ReceiveRelayRoute(data);
+                return;
+            }
+
+            DidUpdateReceivingData?.Invoke(this,
+                new ConnectionDataEventArgs(data, DataComponent.All, ActionState.Completed, 1));
         }
 
         private void ReceiveDataComponent(CommunicationData data, int length, DataComponent dataComponent, Action<byte[]> completion)
@@ -327,87 +632,646 @@ private void ReceiveDataComponent(CommunicationData data, int length, DataCompon
         }
 
         private void ReceiveDataHeader(CommunicationData data) => 
-            ReceiveDataComponent(data, data.Info.HeaderLength, DataComponent.Header, bytes => data.Header = new DataHeaderFooter(bytes));
+            ReceiveDataComponent(data, data.Info.HeaderLength, DataComponent.Header, bytes => data.Header = ReadHeaderFooter(bytes));
 
         private void ReceiveDataContent(CommunicationData data) =>
             ReceiveDataComponent(data, data.Info.ContentLength, DataComponent.Content, bytes => data.InternalContent = bytes);
 
         private void ReceiveDataFooter(CommunicationData data) =>
-            ReceiveDataComponent(data, data.Info.FooterLength, DataComponent.Footer, bytes => data.Footer = new DataHeaderFooter(bytes));
+            ReceiveDataComponent(data, data.Info.FooterLength, DataComponent.Footer, bytes => data.Footer = ReadHeaderFooter(bytes));
 
-        public void SendInformation()
+        private static DataHeaderFooter ReadHeaderFooter(byte[] bytes)
         {
-            var data = Serialization.InformationSerializer.ToData(Information);
-            SendData(new CommunicationData().WithContent(data, DataType.ConnectionInformation));
-       }
+            try
+            {
+                return new DataHeaderFooter(bytes);
+            }
+            catch (ArgumentException exception)
+            {
+                throw new CommunicatorException(CommunicatorErrorCode.ConnectionInvalidFrame, exception);
+            }
+            catch (InvalidOperationException exception)
+            {
+                throw new CommunicatorException(CommunicatorErrorCode.ConnectionInvalidFrame, exception);
+            }
+        }
 
-        public void Send(CommunicationData data)
+        private void ReceiveContentQuery(CommunicationData data)
         {
-            if (data == null)
+            var contentHash = data.Header.ValueForKey(ContentCache.HashKey);
+            var contentQuery = data.Header.ValueForKey(ContentCache.QueryKey);
+            var content = data.GetData();
+            if (contentHash == null || contentQuery == null || content == null || content.Length < 4)
             {
-                throw new ArgumentNullException(nameof(data));
+                throw new CommunicatorException(CommunicatorErrorCode.ConnectionInvalidFrame, null);
             }
 
-            if (!ConnectionSocket.Connected)
+            byte[] cachedContent = null;
+            var cached = ContentCache?.TryGet(contentHash, BitConverter.ToInt32(content, 0), out cachedContent) ?? false;
+            lock (QueriedContents)
             {
-                Disconnect(true);
-                return;
+                if (cached && QueriedContents.Count < MaximumQueriedContents && !QueriedContents.ContainsKey(contentQuery))
+                {
+                    QueriedContents.Add(contentQuery, cachedContent);
+                }
+                else
+                {
+                    cached = false;
+                }
             }
-            
-            ThreadPool.QueueUserWorkItem(state => SendData(data));
+
+            SendReply(new CommunicationData()
+                .WithContent(BitConverter.GetBytes(cached), DataType.ContentReply)
+                .WithHeader(ContentCache.QueryKey, contentQuery));
         }
 
-        private void SendSocketData(ICollection<byte> data, int updatePercentage, Action<float, bool> callback = null)
+        private byte[] TakeQueriedContent(string contentQuery)
         {
-            if (data == null || data.Count == 0)
+            if (contentQuery == null)
             {
-                return;
+                return null;
             }
-
-            var updateFrequency = GenerateUpdateFrequency(updatePercentage, data.Count);
-
-            var bytesSent = 0;
-            while (bytesSent < data.Count)
+            lock (QueriedContents)
             {
-                var maxPacketSize = Math.Min(data.Count - bytesSent, updateFrequency);
-                var dataSubset = data.Skip(bytesSent).Take(maxPacketSize).ToArray();
-
-                var sent = ConnectionSocket.Send(dataSubset);
-                if (sent <= 0)
+                byte[] content;
+                if (QueriedContents.TryGetValue(contentQuery, out content))
                 {
-                    continue;
+                    QueriedContents.Remove(contentQuery);
                 }
-                bytesSent += sent;
-
-                var progress = (float) bytesSent/data.Count;
-                var completed = progress >= 1;
-                callback?.Invoke(progress, completed);
+                return content;
             }
         }
 
-        private void SendData(CommunicationData data)
+        private void ReceiveTransferRequest(CommunicationData data)
         {
-            if (data == null)
+            var transfer = ParallelTransfer.FromHeader(data.Header);
+            if (transfer == null)
             {
-                throw new ArgumentNullException(nameof(data));
+                throw new CommunicatorException(CommunicatorErrorCode.ConnectionInvalidFrame, null);
             }
-            data.PrepareForSending();
 
-            DidUpdateSendingData?.Invoke(this,
-                new ConnectionDataEventArgs(data, DataComponent.All, ActionState.Started, 0));
+            var port = 0;
+            var localEndPoint = Transport?.LocalEndPoint as IPEndPoint;
+            lock (PendingTransfers)
+            {
+                if (PendingTransfers.ContainsKey(transfer.Identifier))
+                {
+                    throw new CommunicatorException(CommunicatorErrorCode.ConnectionInvalidFrame, null);
+                }
+                if (PendingTransfers.Count < MaximumPendingTransfers && localEndPoint != null)
+                {
+                    var listener = new TcpListener(localEndPoint.Address, 0);
+                    try
+                    {
+                        listener.Start();
+                        port = ((IPEndPoint)listener.LocalEndpoint).Port;
+                        PendingTransfers.Add(transfer.Identifier, listener);
+                    }
+                    catch (SocketException)
+                    {
+                        listener.Stop();
+                    }
+                }
+            }
 
-            SendSocketData(data.Info?.GetData(), 100);
+            SendReply(new CommunicationData()
+                .WithContent(BitConverter.GetBytes(port), DataType.TransferAccept)
+                .WithHeader(ParallelTransfer.IdentifierKey, transfer.Identifier.ToString()));
+        }
 
-            SendDataComponent(data, DataComponent.Header, data.Header?.GetData());
-            SendDataComponent(data, DataComponent.Content, data.GetData());
-            SendDataComponent(data, DataComponent.Footer, data.Footer?.GetData());
+        private TcpListener TakePendingTransfer(Guid identifier)
+        {
+            lock (PendingTransfers)
+            {
+                TcpListener listener;
+                if (PendingTransfers.TryGetValue(identifier, out listener))
+                {
+                    PendingTransfers.Remove(identifier);
+                }
+                return listener;
+            }
+        }
 
-            if (data.Info?.DataType == DataType.Termination)
+        private void ReceiveParallelDataContent(CommunicationData data, ParallelTransfer transfer, TcpListener listener)
+        {
+            DidUpdateReceivingData?.Invoke(this,
+                new ConnectionDataEventArgs(data, DataComponent.Content, ActionState.Started, 0));
+
+            try
             {
-                Disconnect(true);
-                return;
+                var remoteAddress = (ConnectedTransport.RemoteEndPoint as IPEndPoint)?.Address;
+                var content = new byte[data.Info.ContentLength];
+                var chunkSize = GenerateUpdateFrequency(ReceivingUpdatePercentage, content.Length)/transfer.StreamCount + 1;
+                var bytesReceived = 0;
+                transfer.Receive(listener, remoteAddress, content, chunkSize, read =>
+                {
+                    var progress = (float)Interlocked.Add(ref bytesReceived, read)/content.Length;
+                    DidUpdateReceivingData?.Invoke(this,
+                        new ConnectionDataEventArgs(data, DataComponent.Content, ActionState.Updating, progress));
+                });
+                data.InternalContent = content;
             }
-            if (data.Info?.DataType == DataType.ConnectionInformation)
+            finally
+            {
+                listener.Stop();
+            }
+
+            DidUpdateReceivingData?.Invoke(this,
+                new ConnectionDataEventArgs(data, DataComponent.Content, ActionState.Completed, 1));
+        }
+
+        public void OpenDatagramChannel()
+        {
+            if (TlsSettings != null)
+            {
+                throw new InvalidOperationException("A datagram channel cannot be opened on a connection secured with TLS");
+            }
+            if (CreateDatagramChannel())
+            {
+                Send(new CommunicationData().WithContent(BitConverter.GetBytes(DatagramChannel.LocalPort), DataType.DatagramChannel));
+            }
+        }
+
+        private void ReceiveDatagramChannel(CommunicationData data)
+        {
+            var content = data.GetData();
+            if (content == null || content.Length < 4 || TlsSettings != null)
+            {
+                return;
+            }
+
+            var remotePort = BitConverter.ToInt32(content, 0);
+            if (remotePort <= IPEndPoint.MinPort || remotePort > IPEndPoint.MaxPort || Information?.EndPoint == null)
+            {
+                throw new CommunicatorException(CommunicatorErrorCode.ConnectionInvalidFrame, null);
+            }
+
+            if (CreateDatagramChannel())
+            {
+                SendReply(new CommunicationData().WithContent(BitConverter.GetBytes(DatagramChannel.LocalPort), DataType.DatagramChannel));
+            }
+            DatagramChannel.Open(remotePort);
+        }
+
+        private bool CreateDatagramChannel()
+        {
+            lock (DatagramLock)
+            {
+                if (DatagramChannel != null)
+                {
+                    return false;
+                }
+                if (Information?.EndPoint == null)
+                {
+                    throw new InvalidOperationException("The connection must be connected to open a datagram channel");
+                }
+
+                DatagramChannel = new DatagramChannel(Information.EndPoint.Address) { FrameLimits = FrameLimits };
+                DatagramChannel.DidReceiveData += (channel, dataArgs) => DidUpdateReceivingData?.Invoke(this, dataArgs);
+                return true;
+            }
+        }
+
+        public void Subscribe(string topic)
+        {
+            TopicIndex.ValidateTopic(topic, true);
+            Send(new CommunicationData().WithContent(new byte[0], DataType.Subscribe).WithHeader(TopicIndex.TopicKey, topic));
+        }
+
+        public void Unsubscribe(string topic)
+        {
+            TopicIndex.ValidateTopic(topic, true);
+            Send(new CommunicationData().WithContent(new byte[0], DataType.Unsubscribe).WithHeader(TopicIndex.TopicKey, topic));
+        }
+
+        private void ReceiveSubscription(CommunicationData data)
+        {
+            var topic = data.Header.ValueForKey(TopicIndex.TopicKey);
+            try
+            {
+                TopicIndex.ValidateTopic(topic, true);
+            }
+            catch (ArgumentException)
+            {
+                return;
+            }
+            DidUpdateSubscription?.Invoke(this, new TopicEventArgs(topic, data.DataType == DataType.Subscribe));
+        }
+
+        public void RegisterRoute(Guid destination)
+        {
+            if (destination == Guid.Empty)
+            {
+                throw new ArgumentException("The destination must not be empty", nameof(destination));
+            }
+            Send(new CommunicationData().WithContent(destination.ToByteArray(), DataType.RelayRoute));
+        }
+
+        private void ReceiveRelayRoute(CommunicationData data)
+        {
+            var content = data.GetData();
+            if (content == null || content.Length != FrameHeader.DestinationSize)
+            {
+                return;
+            }
+            DidRegisterRoute?.Invoke(this, new RouteEventArgs(new Guid(content)));
+        }
+
+        public void SendTo(Guid destination, CommunicationData data)
+        {
+            if (destination == Guid.Empty)
+            {
+                throw new ArgumentException("The destination must not be empty", nameof(destination));
+            }
+            if (data == null)
+            {
+                throw new ArgumentNullException(nameof(data));
+            }
+
+            if (!(Transport?.Connected ?? false))
+            {
+                Disconnect(true);
+                return;
+            }
+
+            ThreadPool.QueueUserWorkItem(state => SendData(data, destination));
+        }
+
+        private void RelayData(FrameHeader frameHeader, Connection destination)
+        {
+            if (RelayBuffer == null)
+            {
+                RelayBuffer = new byte[RelayBufferSize];
+            }
+
+            var remaining = frameHeader.BodyLength;
+            lock (destination.SendLock)
+            {
+                var forwarding = destination.TryRelaySend(FrameHeaderBuffer, frameHeader.Length);
+
+                while (remaining > 0)
+                {
+                    var read = ConnectedTransport.Receive(RelayBuffer, 0, (int)Math.Min(RelayBuffer.Length, remaining));
+                    if (read <= 0)
+                    {
+                        break;
+                    }
+                    remaining -= read;
+
+                    if (forwarding)
+                    {
+                        forwarding = destination.TryRelaySend(RelayBuffer, read);
+                    }
+                }
+
+                if (remaining == 0 && forwarding && destination.TryRelayFlush())
+                {
+                    return;
+                }
+            }
+
+            destination.HandleException(CommunicatorErrorCode.ConnectionTransferFailed, null);
+            if (destination.Transport != null)
+            {
+                destination.Disconnect(true);
+            }
+            if (remaining > 0)
+            {
+                throw new CommunicatorException(CommunicatorErrorCode.ConnectionClosed, null);
+            }
+        }
+
+        private bool TryRelaySend(byte[] buffer, int count)
+        {
+            var transport = Transport;
+            if (transport == null)
+            {
+                return false;
+            }
+
+            try
+            {
+                var bytesSent = 0;
+                while (bytesSent < count)
+                {
+                    bytesSent += transport.Send(buffer, bytesSent, count - bytesSent);
+                }
+                return true;
+            }
+            catch (SocketException)
+            {
+                return false;
+            }
+            catch (ObjectDisposedException)
+            {
+                return false;
+            }
+            catch (CommunicatorException)
+            {
+                return false;
+            }
+        }
+
+        private bool TryRelayFlush()
+        {
+            try
+            {
+                Transport?.Flush();
+                return Transport != null;
+            }
+            catch (SocketException)
+            {
+                return false;
+            }
+            catch (ObjectDisposedException)
+            {
+                return false;
+            }
+            catch (CommunicatorException)
+            {
+                return false;
+            }
+        }
+
+        private int ReserveSendBandwidth(int count)
+        {
+            var length = Math.Min(count, BandwidthQuantum*BandwidthWeight);
+
+            var wait = SendBucket.Reserve(length);
+            if (wait > TimeSpan.Zero)
+            {
+                Thread.Sleep(wait);
+            }
+
+            var sharedWait = SharedSendBucket?.Reserve(length) ?? TimeSpan.Zero;
+            if (sharedWait > TimeSpan.Zero)
+            {
+                Thread.Sleep(sharedWait);
+            }
+
+            Interlocked.Add(ref throttledTicks, wait.Ticks + sharedWait.Ticks);
+            return length;
+        }
+
+        private void RefundSendBandwidth(int count)
+        {
+            SendBucket.Refund(count);
+            SharedSendBucket?.Refund(count);
+        }
+
+        public void SendDatagram(CommunicationData data)
+        {
+            if (data == null)
+            {
+                throw new ArgumentNullException(nameof(data));
+            }
+
+            var datagramChannel = DatagramChannel;
+            if (datagramChannel == null || !datagramChannel.IsOpen)
+            {
+                Send(data);
+                return;
+            }
+
+            try
+            {
+                if (!datagramChannel.Send(data))
+                {
+                    Send(data);
+                }
+            }
+            catch (SocketException)
+            {
+            }
+            catch (InvalidOperationException)
+            {
+            }
+        }
+
+        public void SendInformation()
+        {
+            var data = Serialization.InformationSerializer.ToData(Information);
+            SendData(new CommunicationData().WithContent(data, DataType.ConnectionInformation));
+       }
+
+        public void Send(CommunicationData data)
+        {
+            if (data == null)
+            {
+                throw new ArgumentNullException(nameof(data));
+            }
+
+            if (!(Transport?.Connected ?? false))
+            {
+                Disconnect(true);
+                return;
+            }
+            
+            ThreadPool.QueueUserWorkItem(state => SendData(data));
+        }
+
+        public void Send(Func<CommunicationData> encode)
+        {
+            if (encode == null)
+            {
+                throw new ArgumentNullException(nameof(encode));
+            }
+
+            if (EncodePipelineDepth == 0)
+            {
+                EncodePipeline pendingPipeline;
+                lock (EncodeLock)
+                {
+                    pendingPipeline = EncodePipeline;
+                }
+                pendingPipeline?.WaitUntilEmpty();
+                Send(encode());
+                return;
+            }
+            if (!(Transport?.Connected ?? false))
+            {
+                Disconnect(true);
+                return;
+            }
+
+            EncodePipeline encodePipeline;
+            lock (EncodeLock)
+            {
+                if (EncodePipeline == null)
+                {
+                    EncodePipeline = new EncodePipeline(EncodePipelineDepth, WriteEncodedData, exception => FailSending(CommunicatorErrorCode.ConnectionEncodingFailed, exception));
+                }
+                encodePipeline = EncodePipeline;
+            }
+            encodePipeline.Submit(encode);
+        }
+
+        private void WriteEncodedData(CommunicationData data)
+        {
+            if (Transport != null)
+            {
+                SendData(data);
+            }
+        }
+
+        private void SendReply(CommunicationData data) => new Thread(() => WriteEncodedData(data)) { IsBackground = true }.Start();
+
+        private void SendSocketData(byte[] data, int updatePercentage, Action<float, bool> callback = null)
+        {
+            if (data == null || data.Length == 0)
+            {
+                return;
+            }
+
+            var updateFrequency = GenerateUpdateFrequency(updatePercentage, data.Length);
+
+            var bytesSent = 0;
+            while (bytesSent < data.Length)
+            {
+                var maxPacketSize = Math.Min(data.Length - bytesSent, updateFrequency);
+
+                var sent = ConnectedTransport.Send(data, bytesSent, maxPacketSize);
+                if (sent <= 0)
+                {
+                    continue;
+                }
+                bytesSent += sent;
+
+                var progress = (float) bytesSent/data.Length;
+                var completed = progress >= 1;
+                callback?.Invoke(progress, completed);
+            }
+        }
+
+        private void SendData(CommunicationData data) => SendData(data, Guid.Empty);
+
+        internal void SendData(CommunicationData data, Guid destination)
+        {
+            if (data == null)
+            {
+                throw new ArgumentNullException(nameof(data));
+            }
+
+            var contentHash = destination == Guid.Empty ? CreateContentHash(data) : null;
+            var transfer = destination == Guid.Empty ? CreateParallelTransfer(data) : null;
+            string contentQuery = null;
+            IPEndPoint transferEndPoint = null;
+            try
+            {
+                if (contentHash != null)
+                {
+                    contentQuery = QueryContentCache(contentHash, data.GetData().Length);
+                }
+                if (transfer != null && contentQuery == null)
+                {
+                    transferEndPoint = RequestParallelTransfer(transfer);
+                }
+            }
+            catch (CommunicatorException exception)
+            {
+                FailSending(exception.ErrorCode, exception.InnerException);
+                return;
+            }
+            if (transferEndPoint == null)
+            {
+                transfer = null;
+            }
+
+            lock (SendLock)
+            {
+                try
+                {
+                    data.PrepareForSending();
+                }
+                catch (IOException exception)
+                {
+                    FailSending(CommunicatorErrorCode.ConnectionTransferFailed, exception);
+                    return;
+                }
+
+                var info = data.Info;
+                var header = data.Header;
+                if (transfer != null || contentHash != null || destination != Guid.Empty)
+                {
+                    header = new DataHeaderFooter(new Dictionary<string, string>(data.Header.Entries));
+                    transfer?.AddToHeader(header);
+                    if (contentHash != null)
+                    {
+                        header.SetValueForKey(contentHash, ContentCache.HashKey);
+                    }
+                    if (contentQuery != null)
+                    {
+                        header.SetValueForKey(contentQuery, ContentCache.QueryKey);
+                    }
+                    info = new DataInfo(info.DataType)
+                    {
+                        HeaderLength = header.GetData().Length,
+                        ContentLength = info.ContentLength,
+                        FooterLength = info.FooterLength,
+                        Destination = destination
+                    };
+                }
+
+                try
+                {
+                    DidUpdateSendingData?.Invoke(this,
+                        new ConnectionDataEventArgs(data, DataComponent.All, ActionState.Started, 0));
+
+                    SendSocketData(info?.GetData(), 100);
+
+                    SendDataComponent(data, DataComponent.Header, header?.GetData());
+                    if (contentQuery != null)
+                    {
+                        DidUpdateSendingData?.Invoke(this,
+                            new ConnectionDataEventArgs(data, DataComponent.Content, ActionState.Completed, 1));
+                    }
+                    else if (transferEndPoint != null)
+                    {
+                        SendParallelDataContent(data, transfer, transferEndPoint);
+                    }
+                    else if (data.ContentFilePath != null)
+                    {
+                        SendFileContent(data, info.ContentLength);
+                    }
+                    else
+                    {
+                        SendDataComponent(data, DataComponent.Content, data.GetData());
+                    }
+                    SendDataComponent(data, DataComponent.Footer, data.Footer?.GetData());
+                    ConnectedTransport.Flush();
+
+                    if (data.ContentFilePath != null)
+                    {
+                        TrafficRecorder?.Record(CaptureDirection.Sent, info, header?.GetData(), data.ContentFilePath, data.Footer?.GetData());
+                    }
+                    else
+                    {
+                        TrafficRecorder?.Record(CaptureDirection.Sent, info, header?.GetData(), data.GetData(), data.Footer?.GetData());
+                    }
+                }
+                catch (CommunicatorException exception)
+                {
+                    FailSending(exception.ErrorCode, exception.InnerException);
+                    return;
+                }
+                catch (SocketException exception)
+                {
+                    FailSending(CommunicatorErrorCode.ConnectionClosed, exception);
+                    return;
+                }
+                catch (ObjectDisposedException exception)
+                {
+                    FailSending(CommunicatorErrorCode.ConnectionClosed, exception);
+                    return;
+                }
+            }
+
+            if (data.Info?.DataType == DataType.Termination)
+            {
+                Disconnect(true);
+                return;
+            }
+            if (data.Info?.DataType?.IsControl ?? false)
             {
                 return;
             }
@@ -415,6 +1279,193 @@ private void SendData(CommunicationData data)
                 new ConnectionDataEventArgs(data, DataComponent.All, ActionState.Completed, 1));
         }
 
+        private void FailSending(CommunicatorErrorCode errorCode, Exception innerException)
+        {
+            if (Transport == null)
+            {
+                return;
+            }
+            HandleException(errorCode, innerException);
+            Disconnect(true);
+        }
+
+        private ParallelTransfer CreateParallelTransfer(CommunicationData data)
+        {
+            if (data.ContentFilePath != null || data.DataType.IsControl)
+            {
+                return null;
+            }
+
+            var contentLength = data.GetData()?.Length ?? 0;
+            if (ParallelStreamCount <= 1 || TlsSettings != null || IsSendShaped || contentLength == 0 || contentLength < ParallelTransferThreshold || Information?.EndPoint == null || !(Transport?.LocalEndPoint is IPEndPoint))
+            {
+                return null;
+            }
+
+            return new ParallelTransfer(Guid.NewGuid(), ParallelStreamCount);
+        }
+
+        private string CreateContentHash(CommunicationData data)
+        {
+            if (data.ContentFilePath != null || data.DataType.IsControl)
+            {
+                return null;
+            }
+
+            var content = data.GetData();
+            var contentCache = ContentCache;
+            if (contentCache == null || content == null || content.Length == 0 || content.Length < contentCache.Threshold)
+            {
+                return null;
+            }
+
+            var contentHash = ContentCache.ComputeHash(content);
+            contentCache.Add(contentHash, content);
+            return contentHash;
+        }
+
+        private string QueryContentCache(string contentHash, int contentLength)
+        {
+            var contentQuery = Guid.NewGuid().ToString();
+            var contentReply = ExpectReply(DataType.ContentReply, ContentCache.QueryKey, contentQuery);
+            try
+            {
+                SendData(new CommunicationData()
+                    .WithContent(BitConverter.GetBytes(contentLength), DataType.ContentQuery)
+                    .WithHeader(ContentCache.HashKey, contentHash)
+                    .WithHeader(ContentCache.QueryKey, contentQuery));
+                if (Transport == null)
+                {
+                    throw new CommunicatorException(CommunicatorErrorCode.ConnectionClosed, null);
+                }
+
+                var reply = contentReply.Wait().GetData();
+                return reply?.Length > 0 && BitConverter.ToBoolean(reply, 0) ? contentQuery : null;
+            }
+            finally
+            {
+                RemoveReply(contentReply);
+            }
+        }
+
+        private PendingReply ExpectReply(DataType dataType, string key, string identifier)
+        {
+            var reply = new PendingReply(dataType, key, identifier);
+            lock (PendingReplies)
+            {
+                PendingReplies.Add(reply);
+            }
+            return reply;
+        }
+
+        private void RemoveReply(PendingReply reply)
+        {
+            if (reply == null)
+            {
+                return;
+            }
+            lock (PendingReplies)
+            {
+                PendingReplies.Remove(reply);
+            }
+        }
+
+        private void CompleteReply(CommunicationData data)
+        {
+            lock (PendingReplies)
+            {
+                foreach (var reply in PendingReplies)
+                {
+                    reply.Complete(data);
+                }
+            }
+        }
+
+        private IPEndPoint RequestParallelTransfer(ParallelTransfer transfer)
+        {
+            var transferReply = ExpectReply(DataType.TransferAccept, ParallelTransfer.IdentifierKey, transfer.Identifier.ToString());
+            try
+            {
+                var request = new CommunicationData().WithContent(new byte[0], DataType.TransferRequest);
+                transfer.AddToHeader(request.Header);
+                SendData(request);
+                if (Transport == null)
+                {
+                    throw new CommunicatorException(CommunicatorErrorCode.ConnectionClosed, null);
+                }
+
+                var reply = transferReply.Wait().GetData();
+                if (reply == null || reply.Length < 4)
+                {
+                    throw new CommunicatorException(CommunicatorErrorCode.ConnectionTransferFailed, null);
+                }
+                var port = BitConverter.ToInt32(reply, 0);
+                return port > 0 ? new IPEndPoint(Information.EndPoint.Address, port) : null;
+            }
+            finally
+            {
+                RemoveReply(transferReply);
+            }
+        }
+
+        private void SendParallelDataContent(CommunicationData data, ParallelTransfer transfer, IPEndPoint endPoint)
+        {
+            DidUpdateSendingData?.Invoke(this, new ConnectionDataEventArgs(data, DataComponent.Content, ActionState.Started, 0));
+
+            var content = data.GetData();
+            var chunkSize = GenerateUpdateFrequency(SendingUpdatePercentage, content.Length)/transfer.StreamCount + 1;
+            var bytesSent = 0;
+            transfer.Send(endPoint, content, chunkSize, sent =>
+            {
+                var progress = (float)Interlocked.Add(ref bytesSent, sent)/content.Length;
+                DidUpdateSendingData?.Invoke(this,
+                    new ConnectionDataEventArgs(data, DataComponent.Content, ActionState.Updating, progress));
+            });
+
+            DidUpdateSendingData?.Invoke(this,
+                new ConnectionDataEventArgs(data, DataComponent.Content, ActionState.Completed, 1));
+        }
+
+        private void SendFileContent(CommunicationData data, int length)
+        {
+            DidUpdateSendingData?.Invoke(this, new ConnectionDataEventArgs(data, DataComponent.Content, ActionState.Started, 0));
+
+            try
+            {
+                using (var file = new FileStream(data.ContentFilePath, FileMode.Open, FileAccess.Read, FileShare.Read))
+                {
+                    if (file.Length != length)
+                    {
+                        throw new CommunicatorException(CommunicatorErrorCode.ConnectionTransferFailed, null);
+                    }
+
+                    var updateFrequency = GenerateUpdateFrequency(SendingUpdatePercentage, length);
+                    var nextUpdate = (long)updateFrequency;
+                    ConnectedTransport.SendFile(data.ContentFilePath, length, bytesSent =>
+                    {
+                        if (bytesSent < nextUpdate || bytesSent >= length)
+                        {
+                            return;
+                        }
+                        nextUpdate = bytesSent + updateFrequency;
+                        DidUpdateSendingData?.Invoke(this,
+                            new ConnectionDataEventArgs(data, DataComponent.Content, ActionState.Updating, (float)bytesSent/length));
+                    });
+                }
+            }
+            catch (IOException exception)
+            {
+                throw new CommunicatorException(CommunicatorErrorCode.ConnectionTransferFailed, exception);
+            }
+            catch (UnauthorizedAccessException exception)
+            {
+                throw new CommunicatorException(CommunicatorErrorCode.ConnectionTransferFailed, exception);
+            }
+
+            DidUpdateSendingData?.Invoke(this,
+                new ConnectionDataEventArgs(data, DataComponent.Content, ActionState.Completed, 1));
+        }
+
         private void SendDataComponent(CommunicationData data, DataComponent dataComponent, byte[] bytes)
         {
             if (data == null)
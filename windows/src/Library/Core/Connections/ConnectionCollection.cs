@@ -1,11 +1,40 @@
 ﻿using System;
+using System.Collections;
+using System.Collections.Generic;
 using System.Collections.ObjectModel;
-using System.Linq;
+using System.Net;
 
 namespace Communicate
 {
-    public class ConnectionCollection : Collection<Connection>
+    public class ConnectionCollection : IEnumerable<Connection>
     {
+        private object WriteLock { get; } = new object();
+        private volatile Snapshot snapshot = new Snapshot();
+
+        public int Count => snapshot.Connections.Length;
+        public Connection this[int index] => snapshot.Connections[index];
+
+        public ReadOnlyCollection<Connection> ToSnapshot() => new ReadOnlyCollection<Connection>(snapshot.Connections);
+
+        public Connection Find(Guid identifier)
+        {
+            Connection connection;
+            return snapshot.Identifiers.TryGetValue(identifier, out connection) ? connection : null;
+        }
+
+        public Connection Find(IPEndPoint endPoint)
+        {
+            if (endPoint == null)
+            {
+                throw new ArgumentNullException(nameof(endPoint));
+            }
+
+            Connection connection;
+            return snapshot.EndPoints.TryGetValue(endPoint, out connection) ? connection : null;
+        }
+
+        public bool Contains(Connection connection) => connection != null && ReferenceEquals(Find(connection.Identifier), connection);
+
         public void DisconnectAll(bool disconnectImmediately)
         {
             PerformActionOnAll(connection => connection.Disconnect(disconnectImmediately));
@@ -16,28 +45,116 @@ public void SendToAll(CommunicationData data)
             PerformActionOnAll(connection => connection.Send(data));
         }
 
+        public void SendDatagramToAll(CommunicationData data)
+        {
+            PerformActionOnAll(connection => connection.SendDatagram(data));
+        }
+
         public void PerformActionOnAll(Action<Connection> action)
         {
-            foreach (var connection in this.ToList())
+            if (action == null)
+            {
+                return;
+            }
+            foreach (var connection in snapshot.Connections)
+            {
+                action(connection);
+            }
+        }
+
+        public bool Add(Connection connection)
+        {
+            if (connection == null)
+            {
+                throw new ArgumentNullException(nameof(connection));
+            }
+
+            lock (WriteLock)
             {
-                action?.Invoke(connection);
+                if (Contains(connection))
+                {
+                    return false;
+                }
+                var endPoint = connection.Information?.EndPoint;
+                snapshot = snapshot.Add(connection, endPoint?.Port > 0 ? endPoint : null);
+                return true;
             }
         }
 
-        public new void Add(Connection connection)
+        public bool Remove(Connection connection)
         {
-            if (!Contains(connection))
+            if (connection == null)
             {
-                base.Add(connection);
+                throw new ArgumentNullException(nameof(connection));
+            }
+
+            lock (WriteLock)
+            {
+                if (!Contains(connection))
+                {
+                    return false;
+                }
+                snapshot = snapshot.Remove(connection);
+                return true;
             }
         }
 
-        public new void Remove(Connection connection)
+        public IEnumerator<Connection> GetEnumerator() => ((IEnumerable<Connection>)snapshot.Connections).GetEnumerator();
+
+        IEnumerator IEnumerable.GetEnumerator() => GetEnumerator();
+
+        private class Snapshot
         {
-            if (Contains(connection))
+            internal Snapshot() : this(new Connection[0], new IPEndPoint[0])
+            {
+            }
+
+            private Snapshot(Connection[] connections, IPEndPoint[] endPoints)
+            {
+                Connections = connections;
+                RegisteredEndPoints = endPoints;
+                for (var index = 0; index < connections.Length; index++)
+                {
+                    Identifiers.Add(connections[index].Identifier, connections[index]);
+                    if (endPoints[index] != null && !EndPoints.ContainsKey(endPoints[index]))
+                    {
+                        EndPoints.Add(endPoints[index], connections[index]);
+                    }
+                }
+            }
+
+            public Connection[] Connections { get; }
+            private IPEndPoint[] RegisteredEndPoints { get; }
+
+            public Dictionary<Guid, Connection> Identifiers { get; } = new Dictionary<Guid, Connection>();
+            public Dictionary<IPEndPoint, Connection> EndPoints { get; } = new Dictionary<IPEndPoint, Connection>();
+
+            internal Snapshot Add(Connection connection, IPEndPoint endPoint)
+            {
+                var connections = new Connection[Connections.Length + 1];
+                var endPoints = new IPEndPoint[Connections.Length + 1];
+                Array.Copy(Connections, connections, Connections.Length);
+                Array.Copy(RegisteredEndPoints, endPoints, Connections.Length);
+                connections[Connections.Length] = connection;
+                endPoints[Connections.Length] = endPoint;
+                return new Snapshot(connections, endPoints);
+            }
+
+            internal Snapshot Remove(Connection connection)
             {
-                base.Remove(connection);
+                var index = 0;
+                while (!ReferenceEquals(Connections[index], connection))
+                {
+                    index++;
+                }
+                var connections = new Connection[Connections.Length - 1];
+                var endPoints = new IPEndPoint[Connections.Length - 1];
+                Array.Copy(Connections, connections, index);
+                Array.Copy(RegisteredEndPoints, endPoints, index);
+                Array.Copy(Connections, index + 1, connections, index, connections.Length - index);
+                Array.Copy(RegisteredEndPoints, index + 1, endPoints, index, endPoints.Length - index);
+                return new Snapshot(connections, endPoints);
             }
         }
     }
-}
\ No newline at end of file
+}
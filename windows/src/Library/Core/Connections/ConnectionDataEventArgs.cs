@@ -22,6 +22,28 @@ public ConnectionDataEventArgs(CommunicationData data, DataComponent component,
         public float Progress { get; } = 1;
     }
 
+    internal class TopicEventArgs : EventArgs
+    {
+        public TopicEventArgs(string topic, bool subscribed)
+        {
+            Topic = topic;
+            Subscribed = subscribed;
+        }
+
+        public string Topic { get; }
+        public bool Subscribed { get; }
+    }
+
+    internal class RouteEventArgs : EventArgs
+    {
+        public RouteEventArgs(Guid destination)
+        {
+            Destination = destination;
+        }
+
+        public Guid Destination { get; }
+    }
+
     public class ConnectionEventArgs : ConnectionDataEventArgs
     {
         public ConnectionEventArgs(Connection connection, CommunicationData data, DataComponent component, ActionState state, float progress) : base(data, component, state, progress)
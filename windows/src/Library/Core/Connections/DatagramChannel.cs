@@ -0,0 +1,342 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Net;
+using System.Net.Sockets;
+using System.Threading;
+
+namespace Communicate
+{
+    public class DatagramChannel : IDisposable
+    {
+        internal const int MaximumFragmentSize = 1200;
+
+        private const int FragmentHeaderSize = 8;
+        private const int MaximumPendingMessages = 64;
+        private const int ReceiveBufferSize = 4*1024*1024;
+
+        internal DatagramChannel(IPAddress remoteAddress)
+        {
+            if (remoteAddress == null)
+            {
+                throw new ArgumentNullException(nameof(remoteAddress));
+            }
+
+            RemoteAddress = UnixDomainTransport.IsLocalAddress(remoteAddress) ? IPAddress.Loopback : remoteAddress;
+            ChannelSocket = new Socket(RemoteAddress.AddressFamily, SocketType.Dgram, ProtocolType.Udp);
+            ChannelSocket.Bind(new IPEndPoint(RemoteAddress.AddressFamily == AddressFamily.InterNetworkV6 ? IPAddress.IPv6Any : IPAddress.Any, 0));
+            ChannelSocket.ReceiveTimeout = (int)ReassemblyTimeout.TotalMilliseconds;
+            ChannelSocket.ReceiveBufferSize = ReceiveBufferSize;
+
+            BackgroundThread = new Thread(Receive) { IsBackground = true };
+            BackgroundThread.Start();
+        }
+
+        public IPAddress RemoteAddress { get; }
+        public IPEndPoint RemoteEndPoint { get; private set; }
+        public int LocalPort => ((IPEndPoint)ChannelSocket.LocalEndPoint).Port;
+
+        public bool IsOpen => RemoteEndPoint != null;
+
+        public TimeSpan ReassemblyTimeout { get; private set; } = TimeSpan.FromMilliseconds(200);
+
+        public void SetReassemblyTimeout(TimeSpan reassemblyTimeout)
+        {
+            if (reassemblyTimeout <= TimeSpan.Zero)
+            {
+                throw new ArgumentOutOfRangeException(nameof(reassemblyTimeout), reassemblyTimeout, "The value for this property must be positive");
+            }
+            ReassemblyTimeout = reassemblyTimeout;
+            ChannelSocket.ReceiveTimeout = (int)reassemblyTimeout.TotalMilliseconds;
+        }
+
+        public double SimulatedLossRate { get; private set; }
+        private Random SimulatedLossRandom { get; set; }
+
+        public void SetSimulatedLoss(double simulatedLossRate, int seed)
+        {
+            if (simulatedLossRate < 0 || simulatedLossRate > 1)
+            {
+                throw new ArgumentOutOfRangeException(nameof(simulatedLossRate), simulatedLossRate, "The value for this property must be between 0 and 1");
+            }
+            SimulatedLossRate = simulatedLossRate;
+            SimulatedLossRandom = new Random(seed);
+        }
+
+        public long MessagesSent { get; private set; }
+        public long MessagesReceived { get; private set; }
+        public long MessagesDropped { get; private set; }
+        public long MessagesStale { get; private set; }
+        public long FragmentsReordered { get; private set; }
+
+        internal FrameLimits FrameLimits { get; set; } = new FrameLimits();
+        private int MaximumFragmentCount => (FrameLimits.MaximumDatagramLength + MaximumFragmentSize - 1)/MaximumFragmentSize;
+
+        internal event EventHandler<ConnectionDataEventArgs> DidReceiveData;
+
+        private Socket ChannelSocket { get; }
+        private Thread BackgroundThread { get; }
+
+        private object SendLock { get; } = new object();
+        private uint NextMessageIdentifier { get; set; }
+
+        private Dictionary<uint, Reassembly> PendingMessages { get; } = new Dictionary<uint, Reassembly>();
+        private uint LastDeliveredMessageIdentifier { get; set; }
+        private bool HasDeliveredMessage { get; set; }
+
+        internal void Open(int remotePort)
+        {
+            RemoteEndPoint = new IPEndPoint(RemoteAddress, remotePort);
+        }
+
+        internal bool Send(CommunicationData data)
+        {
+            if (data == null)
+            {
+                throw new ArgumentNullException(nameof(data));
+            }
+            var remoteEndPoint = RemoteEndPoint;
+            if (remoteEndPoint == null)
+            {
+                throw new InvalidOperationException("The datagram channel has not been opened by the remote connection");
+            }
+
+            data.PrepareForSending();
+            var message = Combine(data.Info.GetData(), data.Header.GetData(), data.GetData() ?? new byte[0], data.Footer.GetData());
+
+            var fragmentCount = (message.Length + MaximumFragmentSize - 1)/MaximumFragmentSize;
+            if (fragmentCount > MaximumFragmentCount)
+            {
+                return false;
+            }
+
+            lock (SendLock)
+            {
+                var messageIdentifier = NextMessageIdentifier++;
+                var datagram = new byte[FragmentHeaderSize + MaximumFragmentSize];
+                for (var fragmentIndex = 0; fragmentIndex < fragmentCount; fragmentIndex++)
+                {
+                    var offset = fragmentIndex*MaximumFragmentSize;
+                    var length = Math.Min(MaximumFragmentSize, message.Length - offset);
+
+                    Buffer.BlockCopy(BitConverter.GetBytes(messageIdentifier), 0, datagram, 0, 4);
+                    Buffer.BlockCopy(BitConverter.GetBytes((ushort)fragmentIndex), 0, datagram, 4, 2);
+                    Buffer.BlockCopy(BitConverter.GetBytes((ushort)fragmentCount), 0, datagram, 6, 2);
+                    Buffer.BlockCopy(message, offset, datagram, FragmentHeaderSize, length);
+
+                    if (SimulatedLossRate > 0 && SimulatedLossRandom.NextDouble() < SimulatedLossRate)
+                    {
+                        continue;
+                    }
+                    ChannelSocket.SendTo(datagram, 0, FragmentHeaderSize + length, SocketFlags.None, remoteEndPoint);
+                }
+                MessagesSent++;
+            }
+            return true;
+        }
+
+        private void Receive()
+        {
+            var datagram = new byte[FragmentHeaderSize + MaximumFragmentSize];
+            EndPoint sender = new IPEndPoint(RemoteAddress.AddressFamily == AddressFamily.InterNetworkV6 ? IPAddress.IPv6Any : IPAddress.Any, 0);
+            while (true)
+            {
+                try
+                {
+                    var length = ChannelSocket.ReceiveFrom(datagram, ref sender);
+                    if (sender.Equals(RemoteEndPoint) && length >= FragmentHeaderSize)
+                    {
+                        ReceiveFragment(datagram, length);
+                    }
+                }
+                catch (SocketException exception)
+                {
+                    if (exception.SocketErrorCode != SocketError.TimedOut && exception.SocketErrorCode != SocketError.ConnectionReset)
+                    {
+                        return;
+                    }
+                }
+                catch (ObjectDisposedException)
+                {
+                    return;
+                }
+                DropExpiredMessages();
+            }
+        }
+
+        private void ReceiveFragment(byte[] datagram, int length)
+        {
+            var messageIdentifier = BitConverter.ToUInt32(datagram, 0);
+            var fragmentIndex = BitConverter.ToUInt16(datagram, 4);
+            var fragmentCount = BitConverter.ToUInt16(datagram, 6);
+            if (fragmentCount == 0 || fragmentIndex >= fragmentCount || fragmentCount > MaximumFragmentCount)
+            {
+                return;
+            }
+            if (HasDeliveredMessage && (int)(messageIdentifier - LastDeliveredMessageIdentifier) <= 0)
+            {
+                MessagesStale++;
+                return;
+            }
+
+            Reassembly reassembly;
+            if (!PendingMessages.TryGetValue(messageIdentifier, out reassembly))
+            {
+                if (PendingMessages.Count >= MaximumPendingMessages)
+                {
+                    RemovePendingMessage(PendingMessages.Keys.OrderBy(key => PendingMessages[key].Started).First());
+                }
+                reassembly = new Reassembly(fragmentCount);
+                PendingMessages.Add(messageIdentifier, reassembly);
+            }
+            if (reassembly.Fragments.Length != fragmentCount || reassembly.Fragments[fragmentIndex] != null)
+            {
+                return;
+            }
+
+            if (fragmentIndex < reassembly.LastFragmentIndex)
+            {
+                FragmentsReordered++;
+            }
+            reassembly.LastFragmentIndex = fragmentIndex;
+
+            var fragment = new byte[length - FragmentHeaderSize];
+            Buffer.BlockCopy(datagram, FragmentHeaderSize, fragment, 0, fragment.Length);
+            reassembly.Fragments[fragmentIndex] = fragment;
+            reassembly.FragmentsReceived++;
+
+            if (reassembly.FragmentsReceived == fragmentCount)
+            {
+                PendingMessages.Remove(messageIdentifier);
+                DeliverMessage(messageIdentifier, Combine(reassembly.Fragments));
+            }
+        }
+
+        private void DeliverMessage(uint messageIdentifier, byte[] message)
+        {
+            foreach (var olderMessage in PendingMessages.Keys.Where(key => (int)(key - messageIdentifier) < 0).ToList())
+            {
+                RemovePendingMessage(olderMessage);
+            }
+            LastDeliveredMessageIdentifier = messageIdentifier;
+            HasDeliveredMessage = true;
+
+            var data = ParseMessage(message);
+            if (data == null)
+            {
+                MessagesDropped++;
+                return;
+            }
+
+            MessagesReceived++;
+            DidReceiveData?.Invoke(this, new ConnectionDataEventArgs(data, DataComponent.All, ActionState.Completed, 1));
+        }
+
+        private CommunicationData ParseMessage(byte[] message)
+        {
+            FrameHeader frameHeader;
+            if (!FrameHeader.TryRead(message, 0, out frameHeader) || !FrameLimits.Allows(frameHeader) || message.Length < frameHeader.Length)
+            {
+                return null;
+            }
+            if (frameHeader.HasDestination)
+            {
+                frameHeader = frameHeader.WithDestination(message, FrameHeader.Size);
+            }
+
+            var info = new DataInfo(frameHeader);
+            var headerOffset = frameHeader.Length;
+            var contentOffset = headerOffset + (long)info.HeaderLength;
+            var footerOffset = contentOffset + info.ContentLength;
+            if (footerOffset + info.FooterLength != message.Length)
+            {
+                return null;
+            }
+
+            try
+            {
+                return new CommunicationData(info)
+                {
+                    Header = new DataHeaderFooter(Slice(message, headerOffset, info.HeaderLength)),
+                    InternalContent = Slice(message, (int)contentOffset, info.ContentLength),
+                    Footer = new DataHeaderFooter(Slice(message, (int)footerOffset, info.FooterLength))
+                };
+            }
+            catch (ArgumentException)
+            {
+                return null;
+            }
+            catch (InvalidOperationException)
+            {
+                return null;
+            }
+        }
+
+        private void DropExpiredMessages()
+        {
+            var now = DateTime.UtcNow;
+            foreach (var messageIdentifier in PendingMessages.Keys.Where(key => now - PendingMessages[key].Started > ReassemblyTimeout).ToList())
+            {
+                RemovePendingMessage(messageIdentifier);
+            }
+        }
+
+        private void RemovePendingMessage(uint messageIdentifier)
+        {
+            PendingMessages.Remove(messageIdentifier);
+            MessagesDropped++;
+        }
+
+        private static byte[] Slice(byte[] data, int offset, int length)
+        {
+            var slice = new byte[length];
+            Buffer.BlockCopy(data, offset, slice, 0, length);
+            return slice;
+        }
+
+        private static byte[] Combine(params byte[][] byteArrays)
+        {
+            var combined = new byte[byteArrays.Sum(a => a.Length)];
+            var offset = 0;
+            foreach (var array in byteArrays)
+            {
+                Buffer.BlockCopy(array, 0, combined, offset, array.Length);
+                offset += array.Length;
+            }
+            return combined;
+        }
+
+        public void Close()
+        {
+            RemoteEndPoint = null;
+            ChannelSocket.Close();
+        }
+
+        public void Dispose()
+        {
+            Dispose(true);
+            GC.SuppressFinalize(this);
+        }
+
+        protected virtual void Dispose(bool disposing)
+        {
+            if (disposing)
+            {
+                Close();
+            }
+        }
+
+        private class Reassembly
+        {
+            public Reassembly(int fragmentCount)
+            {
+                Fragments = new byte[fragmentCount][];
+            }
+
+            public byte[][] Fragments { get; }
+            public int FragmentsReceived { get; set; }
+            public int LastFragmentIndex { get; set; }
+            public DateTime Started { get; } = DateTime.UtcNow;
+        }
+    }
+}
@@ -0,0 +1,140 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace Communicate
+{
+    internal class EncodePipeline
+    {
+        internal const int MaximumDepth = 64;
+
+        internal EncodePipeline(int depth, Action<CommunicationData> write, Action<Exception> fail)
+        {
+            if (write == null)
+            {
+                throw new ArgumentNullException(nameof(write));
+            }
+            if (fail == null)
+            {
+                throw new ArgumentNullException(nameof(fail));
+            }
+            Depth = depth;
+            Write = write;
+            Fail = fail;
+        }
+
+        public int Depth
+        {
+            get { return depth; }
+            set
+            {
+                lock (PipelineLock)
+                {
+                    depth = value;
+                    Monitor.PulseAll(PipelineLock);
+                }
+            }
+        }
+
+        private int depth;
+
+        private Action<CommunicationData> Write { get; }
+        private Action<Exception> Fail { get; }
+
+        private object PipelineLock { get; } = new object();
+        private Queue<Task<CommunicationData>> PendingFrames { get; } = new Queue<Task<CommunicationData>>();
+        private bool Writing { get; set; }
+
+        internal void Submit(Func<CommunicationData> encode)
+        {
+            if (encode == null)
+            {
+                throw new ArgumentNullException(nameof(encode));
+            }
+
+            lock (PipelineLock)
+            {
+                while (PendingFrames.Count >= Math.Max(Depth, 1))
+                {
+                    Monitor.Wait(PipelineLock);
+                }
+
+                PendingFrames.Enqueue(Task.Factory.StartNew(encode));
+                if (Writing)
+                {
+                    return;
+                }
+                Writing = true;
+            }
+            ThreadPool.QueueUserWorkItem(state => WritePendingFrames());
+        }
+
+        internal void WaitUntilEmpty()
+        {
+            lock (PipelineLock)
+            {
+                while (Writing || PendingFrames.Count > 0)
+                {
+                    Monitor.Wait(PipelineLock);
+                }
+            }
+        }
+
+        private void WritePendingFrames()
+        {
+            try
+            {
+                while (true)
+                {
+                    Task<CommunicationData> frame;
+                    lock (PipelineLock)
+                    {
+                        if (PendingFrames.Count == 0)
+                        {
+                            Writing = false;
+                            Monitor.PulseAll(PipelineLock);
+                            return;
+                        }
+                        frame = PendingFrames.Peek();
+                    }
+
+                    CommunicationData data = null;
+                    try
+                    {
+                        data = frame.Result;
+                    }
+                    catch (AggregateException exception)
+                    {
+                        Fail(exception.InnerException);
+                    }
+
+                    lock (PipelineLock)
+                    {
+                        PendingFrames.Dequeue();
+                        Monitor.PulseAll(PipelineLock);
+                    }
+
+                    if (data != null)
+                    {
+                        Write(data);
+                    }
+                }
+            }
+            finally
+            {
+                bool restart;
+                lock (PipelineLock)
+                {
+                    restart = Writing && PendingFrames.Count > 0;
+                    Writing = restart;
+                    Monitor.PulseAll(PipelineLock);
+                }
+                if (restart)
+                {
+                    ThreadPool.QueueUserWorkItem(state => WritePendingFrames());
+                }
+            }
+        }
+    }
+}
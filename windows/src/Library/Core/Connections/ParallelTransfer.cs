@@ -0,0 +1,276 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Globalization;
+using System.Net;
+using System.Net.Sockets;
+using System.Threading;
+
+namespace Communicate
+{
+    internal class ParallelTransfer
+    {
+        internal const string IdentifierKey = "TransferIdentifier";
+        internal const string StreamCountKey = "TransferStreams";
+
+        internal const int MaximumStreamCount = 16;
+
+        private const int StripeInfoSize = 24;
+
+        private static readonly int SocketTimeout = (int)PendingReply.Timeout.TotalMilliseconds;
+
+        internal ParallelTransfer(Guid identifier, int streamCount)
+        {
+            if (streamCount < 1 || streamCount > MaximumStreamCount)
+            {
+                throw new ArgumentOutOfRangeException(nameof(streamCount), streamCount, "The number of streams must be between 1 and " + MaximumStreamCount);
+            }
+            Identifier = identifier;
+            StreamCount = streamCount;
+        }
+
+        public Guid Identifier { get; }
+        public int StreamCount { get; }
+
+        internal static ParallelTransfer FromHeader(DataHeaderFooter header)
+        {
+            var identifier = header?.ValueForKey(IdentifierKey);
+            var streamCount = header?.ValueForKey(StreamCountKey);
+            if (identifier == null || streamCount == null)
+            {
+                return null;
+            }
+
+            Guid transferIdentifier;
+            int transferStreamCount;
+            if (!Guid.TryParse(identifier, out transferIdentifier) || !int.TryParse(streamCount, NumberStyles.None, CultureInfo.InvariantCulture, out transferStreamCount))
+            {
+                return null;
+            }
+            if (transferStreamCount < 1 || transferStreamCount > MaximumStreamCount)
+            {
+                return null;
+            }
+            return new ParallelTransfer(transferIdentifier, transferStreamCount);
+        }
+
+        internal void AddToHeader(DataHeaderFooter header)
+        {
+            header.SetValueForKey(Identifier.ToString(), IdentifierKey);
+            header.SetValueForKey(StreamCount.ToString(CultureInfo.InvariantCulture), StreamCountKey);
+        }
+
+        internal void Send(IPEndPoint endPoint, byte[] content, int chunkSize, Action<int> progress)
+        {
+            if (endPoint == null)
+            {
+                throw new ArgumentNullException(nameof(endPoint));
+            }
+            if (content == null)
+            {
+                throw new ArgumentNullException(nameof(content));
+            }
+
+            var stripeLength = StripeLength(content.Length);
+            PerformOnStripes(stripeIndex =>
+            {
+                var offset = Math.Min(stripeIndex*stripeLength, content.Length);
+                var length = Math.Min(stripeLength, content.Length - offset);
+
+                using (var socket = new Socket(endPoint.AddressFamily, SocketType.Stream, ProtocolType.Tcp) { SendTimeout = SocketTimeout })
+                {
+                    socket.Connect(endPoint);
+                    SendAll(socket, GetStripeInfo(offset, length), 0, StripeInfoSize);
+
+                    var sent = 0;
+                    while (sent < length)
+                    {
+                        var size = Math.Min(length - sent, chunkSize);
+                        SendAll(socket, content, offset + sent, size);
+                        sent += size;
+                        progress?.Invoke(size);
+                    }
+                    socket.Shutdown(SocketShutdown.Send);
+                }
+            });
+        }
+
+        internal void Receive(TcpListener listener, IPAddress remoteAddress, byte[] content, int chunkSize, Action<int> progress)
+        {
+            if (listener == null)
+            {
+                throw new ArgumentNullException(nameof(listener));
+            }
+            if (remoteAddress == null)
+            {
+                throw new ArgumentNullException(nameof(remoteAddress));
+            }
+            if (content == null)
+            {
+                throw new ArgumentNullException(nameof(content));
+            }
+
+            var sockets = new List<Socket>();
+            var stripeOffsets = new int[StreamCount];
+            var stripeLengths = new int[StreamCount];
+            try
+            {
+                var deadline = DateTime.UtcNow + PendingReply.Timeout;
+                while (sockets.Count < StreamCount)
+                {
+                    var remaining = deadline - DateTime.UtcNow;
+                    if (remaining <= TimeSpan.Zero)
+                    {
+                        throw new CommunicatorException(CommunicatorErrorCode.ConnectionTransferTimedOut, null);
+                    }
+                    var result = listener.BeginAcceptSocket(null, null);
+                    if (!result.AsyncWaitHandle.WaitOne(remaining))
+                    {
+                        throw new CommunicatorException(CommunicatorErrorCode.ConnectionTransferTimedOut, null);
+                    }
+
+                    var socket = listener.EndAcceptSocket(result);
+                    if (!remoteAddress.Equals((socket.RemoteEndPoint as IPEndPoint)?.Address))
+                    {
+                        socket.Close();
+                        continue;
+                    }
+                    socket.ReceiveTimeout = SocketTimeout;
+                    sockets.Add(socket);
+                }
+
+                PerformOnStripes(stripeIndex =>
+                {
+                    var socket = sockets[stripeIndex];
+                    var stripeInfo = new byte[StripeInfoSize];
+                    ReceiveAll(socket, stripeInfo, 0, StripeInfoSize);
+
+                    var identifier = new byte[16];
+                    Buffer.BlockCopy(stripeInfo, 0, identifier, 0, identifier.Length);
+                    var offset = BitConverter.ToInt32(stripeInfo, 16);
+                    var length = BitConverter.ToInt32(stripeInfo, 20);
+                    if (new Guid(identifier) != Identifier || offset < 0 || length < 0 || offset > content.Length - length)
+                    {
+                        throw new CommunicatorException(CommunicatorErrorCode.ConnectionTransferFailed, null);
+                    }
+                    stripeOffsets[stripeIndex] = offset;
+                    stripeLengths[stripeIndex] = length;
+
+                    var received = 0;
+                    while (received < length)
+                    {
+                        var size = Math.Min(length - received, chunkSize);
+                        ReceiveAll(socket, content, offset + received, size);
+                        received += size;
+                        progress?.Invoke(size);
+                    }
+                }, () => sockets.ForEach(socket => socket.Close()));
+
+                if (!CoversContent(stripeOffsets, stripeLengths, content.Length))
+                {
+                    throw new CommunicatorException(CommunicatorErrorCode.ConnectionTransferFailed, null);
+                }
+            }
+            finally
+            {
+                foreach (var socket in sockets)
+                {
+                    socket.Close();
+                }
+            }
+        }
+
+        private static bool CoversContent(int[] stripeOffsets, int[] stripeLengths, int contentLength)
+        {
+            Array.Sort(stripeOffsets, stripeLengths);
+            var covered = 0;
+            for (var i = 0; i < stripeOffsets.Length; i++)
+            {
+                if (stripeLengths[i] == 0)
+                {
+                    continue;
+                }
+                if (stripeOffsets[i] != covered)
+                {
+                    return false;
+                }
+                covered += stripeLengths[i];
+            }
+            return covered == contentLength;
+        }
+
+        private int StripeLength(int contentLength) => (contentLength + StreamCount - 1)/StreamCount;
+
+        private byte[] GetStripeInfo(int offset, int length)
+        {
+            var stripeInfo = new byte[StripeInfoSize];
+            Buffer.BlockCopy(Identifier.ToByteArray(), 0, stripeInfo, 0, 16);
+            Buffer.BlockCopy(BitConverter.GetBytes(offset), 0, stripeInfo, 16, 4);
+            Buffer.BlockCopy(BitConverter.GetBytes(length), 0, stripeInfo, 20, 4);
+            return stripeInfo;
+        }
+
+        private void PerformOnStripes(Action<int> action) => PerformOnStripes(action, null);
+
+        private void PerformOnStripes(Action<int> action, Action abort)
+        {
+            Exception stripeException = null;
+            var threads = new Thread[StreamCount];
+            for (var i = 0; i < threads.Length; i++)
+            {
+                var stripeIndex = i;
+                threads[i] = new Thread(() =>
+                {
+                    try
+                    {
+                        action(stripeIndex);
+                    }
+                    catch (Exception exception)
+                    {
+                        if (Interlocked.CompareExchange(ref stripeException, exception, null) == null)
+                        {
+                            abort?.Invoke();
+                        }
+                    }
+                }) { IsBackground = true };
+                threads[i].Start();
+            }
+            foreach (var thread in threads)
+            {
+                thread.Join();
+            }
+
+            if (stripeException is CommunicatorException)
+            {
+                throw stripeException;
+            }
+            if (stripeException != null)
+            {
+                throw new CommunicatorException(CommunicatorErrorCode.ConnectionTransferFailed, stripeException);
+            }
+        }
+
+        private static void SendAll(Socket socket, byte[] buffer, int offset, int count)
+        {
+            while (count > 0)
+            {
+                var sent = socket.Send(buffer, offset, count, SocketFlags.None);
+                offset += sent;
+                count -= sent;
+            }
+        }
+
+        private static void ReceiveAll(Socket socket, byte[] buffer, int offset, int count)
+        {
+            while (count > 0)
+            {
+                var read = socket.Receive(buffer, offset, count, SocketFlags.None);
+                if (read <= 0)
+                {
+                    throw new CommunicatorException(CommunicatorErrorCode.ConnectionClosed, null);
+                }
+                offset += read;
+                count -= read;
+            }
+        }
+    }
+}
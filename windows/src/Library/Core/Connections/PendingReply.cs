@@ -0,0 +1,56 @@
+﻿using System;
+using System.Threading;
+
+namespace Communicate
+{
+    internal class PendingReply
+    {
+        internal static readonly TimeSpan Timeout = TimeSpan.FromSeconds(10);
+
+        internal PendingReply(DataType dataType, string key, string identifier)
+        {
+            if (dataType == null)
+            {
+                throw new ArgumentNullException(nameof(dataType));
+            }
+            if (key == null)
+            {
+                throw new ArgumentNullException(nameof(key));
+            }
+            if (identifier == null)
+            {
+                throw new ArgumentNullException(nameof(identifier));
+            }
+
+            DataType = dataType;
+            Key = key;
+            Identifier = identifier;
+        }
+
+        public DataType DataType { get; }
+        public string Key { get; }
+        public string Identifier { get; }
+
+        private CommunicationData Reply { get; set; }
+        private ManualResetEvent RepliedEvent { get; } = new ManualResetEvent(false);
+
+        internal void Complete(CommunicationData data)
+        {
+            if (data?.DataType != DataType || data.Header?.ValueForKey(Key) != Identifier)
+            {
+                return;
+            }
+            Reply = data;
+            RepliedEvent.Set();
+        }
+
+        internal CommunicationData Wait()
+        {
+            if (!RepliedEvent.WaitOne(Timeout))
+            {
+                throw new CommunicatorException(CommunicatorErrorCode.ConnectionTransferTimedOut, null);
+            }
+            return Reply;
+        }
+    }
+}
@@ -0,0 +1,83 @@
+﻿using System;
+using System.Diagnostics;
+using System.Threading;
+
+namespace Communicate
+{
+    internal class TokenBucket
+    {
+        private const int MinimumBurstSize = 64*1024;
+        private const int BurstFraction = 10;
+
+        private object BucketLock { get; } = new object();
+
+        public long BytesPerSecond { get; private set; }
+        private double Tokens { get; set; }
+        private long LastRefill { get; set; } = Stopwatch.GetTimestamp();
+
+        private long throttledTicks;
+        public TimeSpan ThrottledTime => TimeSpan.FromTicks(Interlocked.Read(ref throttledTicks));
+
+        private double BurstSize => Math.Max(MinimumBurstSize, BytesPerSecond/BurstFraction);
+
+        internal void SetBytesPerSecond(long bytesPerSecond)
+        {
+            if (bytesPerSecond < 0)
+            {
+                throw new ArgumentOutOfRangeException(nameof(bytesPerSecond), bytesPerSecond, "The value for this property must not be negative");
+            }
+
+            lock (BucketLock)
+            {
+                Refill();
+                BytesPerSecond = bytesPerSecond;
+                Tokens = Math.Min(Math.Max(Tokens, 0), BurstSize);
+            }
+        }
+
+        internal TimeSpan Reserve(int count)
+        {
+            TimeSpan wait;
+            lock (BucketLock)
+            {
+                if (BytesPerSecond == 0)
+                {
+                    return TimeSpan.Zero;
+                }
+
+                Refill();
+                Tokens -= count;
+                if (Tokens >= 0)
+                {
+                    return TimeSpan.Zero;
+                }
+                wait = TimeSpan.FromSeconds(-Tokens/BytesPerSecond);
+            }
+
+            Interlocked.Add(ref throttledTicks, wait.Ticks);
+            return wait;
+        }
+
+        internal void Refund(int count)
+        {
+            lock (BucketLock)
+            {
+                if (BytesPerSecond > 0)
+                {
+                    Tokens = Math.Min(BurstSize, Tokens + count);
+                }
+            }
+        }
+
+        private void Refill()
+        {
+            var now = Stopwatch.GetTimestamp();
+            var elapsed = (double)(now - LastRefill)/Stopwatch.Frequency;
+            LastRefill = now;
+            if (BytesPerSecond > 0)
+            {
+                Tokens = Math.Min(BurstSize, Tokens + elapsed*BytesPerSecond);
+            }
+        }
+    }
+}
@@ -0,0 +1,176 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Runtime.CompilerServices;
+
+namespace Communicate
+{
+    internal class TopicIndex
+    {
+        internal const string TopicKey = "Topic";
+
+        private const char Separator = '/';
+        private const string Wildcard = "*";
+        private const int MaximumResolvedTopics = 4096;
+
+        private object IndexLock { get; } = new object();
+
+        private Dictionary<string, HashSet<Connection>> ExactSubscriptions { get; } = new Dictionary<string, HashSet<Connection>>();
+        private Dictionary<string, HashSet<Connection>> PrefixSubscriptions { get; } = new Dictionary<string, HashSet<Connection>>();
+        private Dictionary<Connection, HashSet<string>> ConnectionSubscriptions { get; } = new Dictionary<Connection, HashSet<string>>(ConnectionComparer.Instance);
+
+        private Dictionary<string, Connection[]> ResolvedTopics { get; } = new Dictionary<string, Connection[]>();
+
+        internal static string ValidateTopic(string topic, bool allowWildcard)
+        {
+            if (topic == null)
+            {
+                throw new ArgumentNullException(nameof(topic));
+            }
+            if (topic.Length == 0)
+            {
+                throw new ArgumentException("The topic must not be empty", nameof(topic));
+            }
+
+            var wildcardIndex = topic.IndexOf(Wildcard, StringComparison.Ordinal);
+            if (wildcardIndex >= 0 && (!allowWildcard || !IsPrefixTopic(topic) || wildcardIndex != topic.Length - 1))
+            {
+                throw new ArgumentException("A wildcard may only be used as the last segment of a subscription", nameof(topic));
+            }
+            return topic;
+        }
+
+        private static bool IsPrefixTopic(string topic) =>
+            topic == Wildcard || topic.EndsWith(Separator + Wildcard, StringComparison.Ordinal);
+
+        private static string PrefixForTopic(string topic) =>
+            topic == Wildcard ? string.Empty : topic.Substring(0, topic.Length - 2);
+
+        internal void Subscribe(Connection connection, string topic)
+        {
+            lock (IndexLock)
+            {
+                HashSet<string> topics;
+                if (!ConnectionSubscriptions.TryGetValue(connection, out topics))
+                {
+                    topics = new HashSet<string>();
+                    ConnectionSubscriptions.Add(connection, topics);
+                }
+                if (!topics.Add(topic))
+                {
+                    return;
+                }
+
+                var subscriptions = IsPrefixTopic(topic) ? PrefixSubscriptions : ExactSubscriptions;
+                var key = IsPrefixTopic(topic) ? PrefixForTopic(topic) : topic;
+
+                HashSet<Connection> connections;
+                if (!subscriptions.TryGetValue(key, out connections))
+                {
+                    connections = new HashSet<Connection>(ConnectionComparer.Instance);
+                    subscriptions.Add(key, connections);
+                }
+                connections.Add(connection);
+                ResolvedTopics.Clear();
+            }
+        }
+
+        internal void Unsubscribe(Connection connection, string topic)
+        {
+            lock (IndexLock)
+            {
+                HashSet<string> topics;
+                if (!ConnectionSubscriptions.TryGetValue(connection, out topics) || !topics.Remove(topic))
+                {
+                    return;
+                }
+                if (topics.Count == 0)
+                {
+                    ConnectionSubscriptions.Remove(connection);
+                }
+
+                RemoveSubscription(connection, topic);
+                ResolvedTopics.Clear();
+            }
+        }
+
+        internal void RemoveConnection(Connection connection)
+        {
+            lock (IndexLock)
+            {
+                HashSet<string> topics;
+                if (!ConnectionSubscriptions.TryGetValue(connection, out topics))
+                {
+                    return;
+                }
+                ConnectionSubscriptions.Remove(connection);
+
+                foreach (var topic in topics)
+                {
+                    RemoveSubscription(connection, topic);
+                }
+                ResolvedTopics.Clear();
+            }
+        }
+
+        private void RemoveSubscription(Connection connection, string topic)
+        {
+            var subscriptions = IsPrefixTopic(topic) ? PrefixSubscriptions : ExactSubscriptions;
+            var key = IsPrefixTopic(topic) ? PrefixForTopic(topic) : topic;
+
+            HashSet<Connection> connections;
+            if (subscriptions.TryGetValue(key, out connections) && connections.Remove(connection) && connections.Count == 0)
+            {
+                subscriptions.Remove(key);
+            }
+        }
+
+        internal Connection[] ConnectionsForTopic(string topic)
+        {
+            lock (IndexLock)
+            {
+                Connection[] resolved;
+                if (ResolvedTopics.TryGetValue(topic, out resolved))
+                {
+                    return resolved;
+                }
+
+                var connections = new HashSet<Connection>(ConnectionComparer.Instance);
+                HashSet<Connection> subscribers;
+                if (ExactSubscriptions.TryGetValue(topic, out subscribers))
+                {
+                    connections.UnionWith(subscribers);
+                }
+                if (PrefixSubscriptions.Count > 0)
+                {
+                    var separatorIndex = -1;
+                    do
+                    {
+                        var prefix = separatorIndex < 0 ? string.Empty : topic.Substring(0, separatorIndex);
+                        if (PrefixSubscriptions.TryGetValue(prefix, out subscribers))
+                        {
+                            connections.UnionWith(subscribers);
+                        }
+                        separatorIndex = topic.IndexOf(Separator, separatorIndex + 1);
+                    } while (separatorIndex >= 0);
+                }
+
+                resolved = connections.ToArray();
+                if (ResolvedTopics.Count >= MaximumResolvedTopics)
+                {
+                    ResolvedTopics.Clear();
+                }
+                ResolvedTopics[topic] = resolved;
+                return resolved;
+            }
+        }
+
+        private class ConnectionComparer : IEqualityComparer<Connection>
+        {
+            public static ConnectionComparer Instance { get; } = new ConnectionComparer();
+
+            public bool Equals(Connection x, Connection y) => ReferenceEquals(x, y);
+            public int GetHashCode(Connection connection) => RuntimeHelpers.GetHashCode(connection);
+        }
+    }
+}
@@ -0,0 +1,169 @@
+﻿using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Threading;
+
+namespace Communicate
+{
+    public class TrafficCapture
+    {
+        private const int ReadBufferSize = 64*1024;
+
+        public TrafficCapture(string path)
+        {
+            if (path == null)
+            {
+                throw new ArgumentNullException(nameof(path));
+            }
+            if (!File.Exists(path))
+            {
+                throw new FileNotFoundException("The capture file was not found", path);
+            }
+            Path = System.IO.Path.GetFullPath(path);
+        }
+
+        public string Path { get; }
+
+        public IEnumerable<CapturedFrame> ReadFrames()
+        {
+            using (var stream = new FileStream(Path, FileMode.Open, FileAccess.Read, FileShare.ReadWrite, ReadBufferSize))
+            using (var reader = new BinaryReader(stream))
+            {
+                if (stream.Length < TrafficRecorder.FileHeaderSize)
+                {
+                    throw new InvalidDataException("The capture file is missing its header");
+                }
+                if (reader.ReadInt32() != TrafficRecorder.FileMagic || reader.ReadInt16() != TrafficRecorder.FileVersion)
+                {
+                    throw new InvalidDataException("The file is not a supported capture file");
+                }
+                reader.ReadInt16();
+
+                const int recordFieldsSize = TrafficRecorder.RecordPrefixSize - sizeof(int);
+                var frameHeaderBuffer = new byte[FrameHeader.MaximumSize];
+                while (stream.Length - stream.Position >= TrafficRecorder.RecordPrefixSize + FrameHeader.Size)
+                {
+                    var recordLength = reader.ReadInt32();
+                    if (recordLength < recordFieldsSize + FrameHeader.Size || stream.Length - stream.Position < recordLength)
+                    {
+                        yield break;
+                    }
+
+                    var timestamp = new DateTime(reader.ReadInt64(), DateTimeKind.Utc);
+                    var direction = (CaptureDirection)reader.ReadByte();
+                    reader.ReadBytes(3);
+
+                    FrameHeader frameHeader;
+                    if (!ReadExactly(stream, frameHeaderBuffer, 0, FrameHeader.Size))
+                    {
+                        yield break;
+                    }
+                    if (!FrameHeader.TryRead(frameHeaderBuffer, 0, out frameHeader))
+                    {
+                        throw new InvalidDataException("The capture file contains an invalid frame");
+                    }
+                    if (frameHeader.HasDestination)
+                    {
+                        if (recordLength < recordFieldsSize + FrameHeader.MaximumSize || !ReadExactly(stream, frameHeaderBuffer, FrameHeader.Size, FrameHeader.DestinationSize))
+                        {
+                            yield break;
+                        }
+                        frameHeader = frameHeader.WithDestination(frameHeaderBuffer, FrameHeader.Size);
+                    }
+                    if (recordFieldsSize + frameHeader.Length + frameHeader.BodyLength != recordLength)
+                    {
+                        throw new InvalidDataException("The capture file contains a record whose length does not match its frame");
+                    }
+
+                    var header = reader.ReadBytes(frameHeader.HeaderLength);
+                    var content = reader.ReadBytes(frameHeader.ContentLength);
+                    var footer = reader.ReadBytes(frameHeader.FooterLength);
+                    if (header.Length != frameHeader.HeaderLength || content.Length != frameHeader.ContentLength || footer.Length != frameHeader.FooterLength)
+                    {
+                        yield break;
+                    }
+
+                    var data = new CommunicationData(new DataInfo(frameHeader))
+                    {
+                        Header = new DataHeaderFooter(header),
+                        InternalContent = content,
+                        Footer = new DataHeaderFooter(footer)
+                    };
+                    yield return new CapturedFrame(timestamp, direction, data);
+                }
+            }
+        }
+
+        private static bool ReadExactly(Stream stream, byte[] buffer, int offset, int count)
+        {
+            while (count > 0)
+            {
+                var read = stream.Read(buffer, offset, count);
+                if (read <= 0)
+                {
+                    return false;
+                }
+                offset += read;
+                count -= read;
+            }
+            return true;
+        }
+
+        public void Replay(Connection connection, CaptureDirection direction, bool preservePacing)
+        {
+            if (connection == null)
+            {
+                throw new ArgumentNullException(nameof(connection));
+            }
+            Replay(new[] { connection }, direction, preservePacing);
+        }
+
+        public void Replay(BaseCommunicator communicator, CaptureDirection direction, bool preservePacing)
+        {
+            if (communicator == null)
+            {
+                throw new ArgumentNullException(nameof(communicator));
+            }
+            Replay(communicator.Connections.ToSnapshot(), direction, preservePacing);
+        }
+
+        private void Replay(IList<Connection> connections, CaptureDirection direction, bool preservePacing)
+        {
+            var firstTimestamp = DateTime.MinValue;
+            var started = DateTime.UtcNow;
+            foreach (var frame in ReadFrames())
+            {
+                if (frame.Direction != direction || frame.Data.DataType.IsControl)
+                {
+                    continue;
+                }
+
+                if (preservePacing)
+                {
+                    if (firstTimestamp == DateTime.MinValue)
+                    {
+                        firstTimestamp = frame.Timestamp;
+                    }
+                    var wait = (frame.Timestamp - firstTimestamp) - (DateTime.UtcNow - started);
+                    if (wait > TimeSpan.Zero)
+                    {
+                        Thread.Sleep(wait);
+                    }
+                }
+
+                var data = frame.Data;
+                data.Header.Entries.Remove(ParallelTransfer.IdentifierKey);
+                data.Header.Entries.Remove(ParallelTransfer.StreamCountKey);
+                data.Header.Entries.Remove(ContentCache.HashKey);
+                data.Header.Entries.Remove(ContentCache.QueryKey);
+                foreach (var connection in connections)
+                {
+                    if (connection.State == ConnectionState.Connected)
+                    {
+                        connection.SendData(data, data.Info.Destination);
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,174 @@
+﻿using System;
+using System.IO;
+
+namespace Communicate
+{
+    public class TrafficRecorder : IDisposable
+    {
+        internal const int FileMagic = 0x50414343;
+        internal const short FileVersion = 1;
+        internal const int FileHeaderSize = 8;
+        internal const int RecordPrefixSize = 16;
+
+        private const int BufferSize = 64*1024;
+
+        public TrafficRecorder(string path)
+        {
+            if (path == null)
+            {
+                throw new ArgumentNullException(nameof(path));
+            }
+
+            Path = System.IO.Path.GetFullPath(path);
+            Stream = new FileStream(Path, FileMode.Append, FileAccess.Write, FileShare.Read, BufferSize);
+            Writer = new BinaryWriter(Stream);
+            if (Stream.Length == 0)
+            {
+                Writer.Write(FileMagic);
+                Writer.Write(FileVersion);
+                Writer.Write((short)0);
+            }
+        }
+
+        public string Path { get; }
+        public long FramesRecorded { get; private set; }
+
+        private FileStream Stream { get; }
+        private BinaryWriter Writer { get; }
+        private byte[] FrameHeaderBuffer { get; } = new byte[FrameHeader.MaximumSize];
+        private bool Closed { get; set; }
+
+        internal void Record(CaptureDirection direction, DataInfo info, byte[] header, byte[] content, byte[] footer)
+        {
+            content = content ?? new byte[0];
+            Record(direction, info, header, content.Length, () =>
+            {
+                Writer.Write(content);
+                return true;
+            }, footer);
+        }
+
+        internal void Record(CaptureDirection direction, DataInfo info, byte[] header, string contentFilePath, byte[] footer)
+        {
+            if (contentFilePath == null)
+            {
+                throw new ArgumentNullException(nameof(contentFilePath));
+            }
+
+            FileStream file;
+            try
+            {
+                file = new FileStream(contentFilePath, FileMode.Open, FileAccess.Read, FileShare.Read, BufferSize);
+            }
+            catch (IOException)
+            {
+                return;
+            }
+            catch (UnauthorizedAccessException)
+            {
+                return;
+            }
+
+            using (file)
+            {
+                if (file.Length != info.ContentLength)
+                {
+                    return;
+                }
+                Record(direction, info, header, info.ContentLength, () => CopyContent(file, info.ContentLength), footer);
+            }
+        }
+
+        private void Record(CaptureDirection direction, DataInfo info, byte[] header, int contentLength, Func<bool> writeContent, byte[] footer)
+        {
+            header = header ?? new byte[0];
+            footer = footer ?? new byte[0];
+            var frameHeader = new FrameHeader(info.DataType.Identifier, header.Length, contentLength, footer.Length, info.Destination);
+
+            lock (Writer)
+            {
+                if (Closed)
+                {
+                    return;
+                }
+
+                frameHeader.Write(FrameHeaderBuffer, 0);
+                Writer.Write((int)(RecordPrefixSize - sizeof(int) + frameHeader.Length + frameHeader.BodyLength));
+                Writer.Write(DateTime.UtcNow.Ticks);
+                Writer.Write((byte)direction);
+                Writer.Write((byte)0);
+                Writer.Write((short)0);
+                Writer.Write(FrameHeaderBuffer, 0, frameHeader.Length);
+                Writer.Write(header);
+                if (!writeContent())
+                {
+                    // The record is already partly written, so stop here and leave it as a short record that ends the capture.
+                    Closed = true;
+                    Writer.Dispose();
+                    return;
+                }
+                Writer.Write(footer);
+                FramesRecorded++;
+            }
+        }
+
+        private bool CopyContent(Stream content, int length)
+        {
+            var buffer = new byte[Math.Min(length, BufferSize)];
+            var remaining = length;
+            while (remaining > 0)
+            {
+                int read;
+                try
+                {
+                    read = content.Read(buffer, 0, Math.Min(buffer.Length, remaining));
+                }
+                catch (IOException)
+                {
+                    return false;
+                }
+                if (read <= 0)
+                {
+                    return false;
+                }
+                Writer.Write(buffer, 0, read);
+                remaining -= read;
+            }
+            return true;
+        }
+
+        public void Flush()
+        {
+            lock (Writer)
+            {
+                if (!Closed)
+                {
+                    Writer.Flush();
+                }
+            }
+        }
+
+        public void Dispose()
+        {
+            Dispose(true);
+            GC.SuppressFinalize(this);
+        }
+
+        protected virtual void Dispose(bool disposing)
+        {
+            if (!disposing)
+            {
+                return;
+            }
+            lock (Writer)
+            {
+                if (Closed)
+                {
+                    return;
+                }
+                Closed = true;
+                Writer.Dispose();
+            }
+        }
+    }
+}
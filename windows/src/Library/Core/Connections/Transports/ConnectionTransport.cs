@@ -0,0 +1,68 @@
+﻿using System;
+using System.IO;
+using System.Net;
+
+namespace Communicate
+{
+    public abstract class ConnectionTransport : IDisposable
+    {
+        private const int FileChunkSize = 64*1024;
+
+        public abstract bool Connected { get; }
+        public abstract EndPoint RemoteEndPoint { get; }
+        public virtual EndPoint LocalEndPoint => null;
+
+        public abstract int Send(byte[] buffer, int offset, int count);
+        public abstract int Receive(byte[] buffer, int offset, int count);
+
+        public virtual void Flush()
+        {
+        }
+
+        public virtual void SendFile(string path, long length, Action<long> progress)
+        {
+            if (path == null)
+            {
+                throw new ArgumentNullException(nameof(path));
+            }
+
+            var buffer = new byte[FileChunkSize];
+            using (var file = new FileStream(path, FileMode.Open, FileAccess.Read, FileShare.Read, FileChunkSize, FileOptions.SequentialScan))
+            {
+                var bytesSent = 0L;
+                while (bytesSent < length)
+                {
+                    var read = file.Read(buffer, 0, (int)Math.Min(buffer.Length, length - bytesSent));
+                    if (read <= 0)
+                    {
+                        throw new CommunicatorException(CommunicatorErrorCode.ConnectionTransferFailed, null);
+                    }
+
+                    var offset = 0;
+                    while (offset < read)
+                    {
+                        offset += Send(buffer, offset, read - offset);
+                    }
+                    bytesSent += read;
+                    progress?.Invoke(bytesSent);
+                }
+            }
+        }
+
+        public abstract void Close();
+
+        public void Dispose()
+        {
+            Dispose(true);
+            GC.SuppressFinalize(this);
+        }
+
+        protected virtual void Dispose(bool disposing)
+        {
+            if (disposing)
+            {
+                Close();
+            }
+        }
+    }
+}
@@ -0,0 +1,61 @@
+﻿using System;
+
+namespace Communicate
+{
+    public class LinkConditions
+    {
+        public LinkConditions() : this(0)
+        {
+        }
+
+        public LinkConditions(int seed)
+        {
+            Seed = seed;
+        }
+
+        public int Seed { get; }
+
+        public TimeSpan Latency { get; private set; } = TimeSpan.Zero;
+        public TimeSpan Jitter { get; private set; } = TimeSpan.Zero;
+        public long BandwidthLimit { get; private set; }
+
+        // The probability that a single Send call resets the whole link, not a per-packet loss rate.
+        public double ResetProbabilityPerSend { get; private set; }
+
+        public void SetLatency(TimeSpan latency)
+        {
+            if (latency < TimeSpan.Zero)
+            {
+                throw new ArgumentOutOfRangeException(nameof(latency), latency, "The value for this property must not be negative");
+            }
+            Latency = latency;
+        }
+
+        public void SetJitter(TimeSpan jitter)
+        {
+            if (jitter < TimeSpan.Zero)
+            {
+                throw new ArgumentOutOfRangeException(nameof(jitter), jitter, "The value for this property must not be negative");
+            }
+            Jitter = jitter;
+        }
+
+        public void SetBandwidthLimit(long bandwidthLimit)
+        {
+            if (bandwidthLimit < 0)
+            {
+                throw new ArgumentOutOfRangeException(nameof(bandwidthLimit), bandwidthLimit, "The value for this property must not be negative");
+            }
+            BandwidthLimit = bandwidthLimit;
+        }
+
+        public void SetResetProbabilityPerSend(double resetProbabilityPerSend)
+        {
+            if (resetProbabilityPerSend < 0 || resetProbabilityPerSend > 1)
+            {
+                throw new ArgumentOutOfRangeException(nameof(resetProbabilityPerSend), resetProbabilityPerSend, "The value for this property must be between 0 and 1");
+            }
+            ResetProbabilityPerSend = resetProbabilityPerSend;
+        }
+    }
+}
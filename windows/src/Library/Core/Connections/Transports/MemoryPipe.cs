@@ -0,0 +1,170 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Net.Sockets;
+using System.Threading;
+
+namespace Communicate
+{
+    internal class MemoryPipe
+    {
+        private const int MaximumBufferedBytes = 1024*1024;
+
+        internal MemoryPipe(LinkConditions conditions, int seed)
+        {
+            if (conditions == null)
+            {
+                throw new ArgumentNullException(nameof(conditions));
+            }
+            Conditions = conditions;
+            Random = new Random(seed);
+        }
+
+        private LinkConditions Conditions { get; }
+        private Random Random { get; }
+
+        private object PipeLock { get; } = new object();
+        private Queue<Segment> Segments { get; } = new Queue<Segment>();
+        private int BufferedBytes { get; set; }
+        private long LinkAvailable { get; set; }
+        private long LastDelivery { get; set; }
+
+        public bool Closed { get; private set; }
+
+        public bool CanRead
+        {
+            get
+            {
+                lock (PipeLock)
+                {
+                    return !Closed || Segments.Count > 0;
+                }
+            }
+        }
+
+        internal bool ShouldReset()
+        {
+            lock (PipeLock)
+            {
+                return Conditions.ResetProbabilityPerSend > 0 && Random.NextDouble() < Conditions.ResetProbabilityPerSend;
+            }
+        }
+
+        internal int Write(byte[] buffer, int offset, int count)
+        {
+            if (buffer == null)
+            {
+                throw new ArgumentNullException(nameof(buffer));
+            }
+
+            lock (PipeLock)
+            {
+                while (!Closed && BufferedBytes >= MaximumBufferedBytes)
+                {
+                    Monitor.Wait(PipeLock);
+                }
+                if (Closed)
+                {
+                    throw new SocketException((int)SocketError.ConnectionReset);
+                }
+
+                var length = Math.Min(count, MaximumBufferedBytes - BufferedBytes);
+                var data = new byte[length];
+                Buffer.BlockCopy(buffer, offset, data, 0, length);
+
+                var now = Stopwatch.GetTimestamp();
+                LinkAvailable = Math.Max(now, LinkAvailable);
+                if (Conditions.BandwidthLimit > 0)
+                {
+                    LinkAvailable += length*Stopwatch.Frequency/Conditions.BandwidthLimit;
+                }
+
+                var delay = Conditions.Latency.TotalSeconds + Conditions.Jitter.TotalSeconds*Random.NextDouble();
+                LastDelivery = Math.Max(LastDelivery, LinkAvailable + (long)(delay*Stopwatch.Frequency));
+
+                Segments.Enqueue(new Segment(data, LastDelivery));
+                BufferedBytes += length;
+                Monitor.PulseAll(PipeLock);
+                return length;
+            }
+        }
+
+        internal int Read(byte[] buffer, int offset, int count)
+        {
+            if (buffer == null)
+            {
+                throw new ArgumentNullException(nameof(buffer));
+            }
+
+            lock (PipeLock)
+            {
+                while (true)
+                {
+                    if (Segments.Count == 0)
+                    {
+                        if (Closed)
+                        {
+                            throw new SocketException((int)SocketError.ConnectionReset);
+                        }
+                        Monitor.Wait(PipeLock);
+                        continue;
+                    }
+
+                    var wait = Segments.Peek().Delivery - Stopwatch.GetTimestamp();
+                    if (wait > 0)
+                    {
+                        Monitor.Wait(PipeLock, TimeSpan.FromSeconds((double)wait/Stopwatch.Frequency));
+                        continue;
+                    }
+                    break;
+                }
+
+                var read = 0;
+                var now = Stopwatch.GetTimestamp();
+                while (read < count && Segments.Count > 0 && Segments.Peek().Delivery <= now)
+                {
+                    var segment = Segments.Peek();
+                    var length = Math.Min(count - read, segment.Data.Length - segment.Offset);
+                    Buffer.BlockCopy(segment.Data, segment.Offset, buffer, offset + read, length);
+                    segment.Offset += length;
+                    read += length;
+                    if (segment.Offset == segment.Data.Length)
+                    {
+                        Segments.Dequeue();
+                    }
+                }
+
+                BufferedBytes -= read;
+                Monitor.PulseAll(PipeLock);
+                return read;
+            }
+        }
+
+        internal void Close(bool discard)
+        {
+            lock (PipeLock)
+            {
+                Closed = true;
+                if (discard)
+                {
+                    Segments.Clear();
+                    BufferedBytes = 0;
+                }
+                Monitor.PulseAll(PipeLock);
+            }
+        }
+
+        private class Segment
+        {
+            internal Segment(byte[] data, long delivery)
+            {
+                Data = data;
+                Delivery = delivery;
+            }
+
+            public byte[] Data { get; }
+            public long Delivery { get; }
+            public int Offset { get; set; }
+        }
+    }
+}
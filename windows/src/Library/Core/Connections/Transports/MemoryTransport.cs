@@ -0,0 +1,71 @@
+﻿using System;
+using System.Net;
+using System.Net.Sockets;
+
+namespace Communicate
+{
+    public class MemoryTransport : ConnectionTransport
+    {
+        private MemoryTransport(MemoryPipe incoming, MemoryPipe outgoing)
+        {
+            Incoming = incoming;
+            Outgoing = outgoing;
+        }
+
+        private MemoryPipe Incoming { get; }
+        private MemoryPipe Outgoing { get; }
+        private bool Closed { get; set; }
+
+        public override bool Connected => !Closed && Incoming.CanRead;
+        public override EndPoint RemoteEndPoint => null;
+
+        public static void CreatePair(LinkConditions conditions, out MemoryTransport client, out MemoryTransport server)
+        {
+            if (conditions == null)
+            {
+                throw new ArgumentNullException(nameof(conditions));
+            }
+
+            var clientToServer = new MemoryPipe(conditions, conditions.Seed);
+            var serverToClient = new MemoryPipe(conditions, ~conditions.Seed);
+            client = new MemoryTransport(serverToClient, clientToServer);
+            server = new MemoryTransport(clientToServer, serverToClient);
+        }
+
+        public override int Send(byte[] buffer, int offset, int count)
+        {
+            if (Closed)
+            {
+                throw new ObjectDisposedException(GetType().FullName);
+            }
+            if (Outgoing.ShouldReset())
+            {
+                Reset();
+                throw new SocketException((int)SocketError.ConnectionReset);
+            }
+            return Outgoing.Write(buffer, offset, count);
+        }
+
+        public override int Receive(byte[] buffer, int offset, int count)
+        {
+            if (Closed)
+            {
+                throw new ObjectDisposedException(GetType().FullName);
+            }
+            return Incoming.Read(buffer, offset, count);
+        }
+
+        private void Reset()
+        {
+            Outgoing.Close(true);
+            Incoming.Close(true);
+        }
+
+        public override void Close()
+        {
+            Closed = true;
+            Outgoing.Close(false);
+            Incoming.Close(true);
+        }
+    }
+}
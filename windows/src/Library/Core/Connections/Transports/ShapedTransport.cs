@@ -0,0 +1,73 @@
+﻿using System;
+using System.Net;
+
+namespace Communicate
+{
+    internal class ShapedTransport : ConnectionTransport
+    {
+        internal ShapedTransport(ConnectionTransport innerTransport, Func<int, int> reserve, Action<int> refund, Func<bool> isShaped)
+        {
+            if (innerTransport == null)
+            {
+                throw new ArgumentNullException(nameof(innerTransport));
+            }
+            if (reserve == null)
+            {
+                throw new ArgumentNullException(nameof(reserve));
+            }
+            if (refund == null)
+            {
+                throw new ArgumentNullException(nameof(refund));
+            }
+            if (isShaped == null)
+            {
+                throw new ArgumentNullException(nameof(isShaped));
+            }
+            InnerTransport = innerTransport;
+            Reserve = reserve;
+            Refund = refund;
+            IsShaped = isShaped;
+        }
+
+        public ConnectionTransport InnerTransport { get; }
+        private Func<int, int> Reserve { get; }
+        private Action<int> Refund { get; }
+        private Func<bool> IsShaped { get; }
+
+        public override bool Connected => InnerTransport.Connected;
+        public override EndPoint RemoteEndPoint => InnerTransport.RemoteEndPoint;
+        public override EndPoint LocalEndPoint => InnerTransport.LocalEndPoint;
+
+        public override int Send(byte[] buffer, int offset, int count)
+        {
+            if (!IsShaped())
+            {
+                return InnerTransport.Send(buffer, offset, count);
+            }
+
+            var reserved = Reserve(count);
+            var sent = InnerTransport.Send(buffer, offset, reserved);
+            if (sent < reserved)
+            {
+                Refund(reserved - Math.Max(sent, 0));
+            }
+            return sent;
+        }
+
+        public override void SendFile(string path, long length, Action<long> progress)
+        {
+            if (IsShaped())
+            {
+                base.SendFile(path, length, progress);
+                return;
+            }
+            InnerTransport.SendFile(path, length, progress);
+        }
+
+        public override int Receive(byte[] buffer, int offset, int count) => InnerTransport.Receive(buffer, offset, count);
+
+        public override void Flush() => InnerTransport.Flush();
+
+        public override void Close() => InnerTransport.Close();
+    }
+}
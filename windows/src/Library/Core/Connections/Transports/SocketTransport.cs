@@ -0,0 +1,58 @@
+﻿using System;
+using System.Net;
+using System.Net.Sockets;
+
+namespace Communicate
+{
+    public class SocketTransport : ConnectionTransport
+    {
+        public SocketTransport(Socket socket)
+        {
+            if (socket == null)
+            {
+                throw new ArgumentNullException(nameof(socket));
+            }
+            Socket = socket;
+        }
+
+        public Socket Socket { get; }
+
+        public override bool Connected => Socket.Connected;
+        public override EndPoint RemoteEndPoint => Socket.RemoteEndPoint;
+        public override EndPoint LocalEndPoint => Socket.LocalEndPoint;
+
+        public override int Send(byte[] buffer, int offset, int count) => Socket.Send(buffer, offset, count, SocketFlags.None);
+        public override int Receive(byte[] buffer, int offset, int count) => Socket.Receive(buffer, offset, count, SocketFlags.None);
+
+        public override void SendFile(string path, long length, Action<long> progress)
+        {
+            if (path == null)
+            {
+                throw new ArgumentNullException(nameof(path));
+            }
+
+            Socket.SendFile(path);
+            progress?.Invoke(length);
+        }
+
+        public override void Close() => Socket.Close();
+
+        internal static SocketTransport Connect(IPEndPoint endPoint)
+        {
+            if (endPoint == null)
+            {
+                throw new ArgumentNullException(nameof(endPoint));
+            }
+
+            var localSocket = UnixDomainTransport.TryConnect(endPoint);
+            if (localSocket != null)
+            {
+                return new SocketTransport(localSocket);
+            }
+
+            var socket = new Socket(endPoint.AddressFamily, SocketType.Stream, ProtocolType.Tcp);
+            socket.Connect(endPoint);
+            return new SocketTransport(socket);
+        }
+    }
+}
@@ -0,0 +1,41 @@
+﻿using System;
+using System.Net.Security;
+using System.Security.Authentication;
+using System.Security.Cryptography.X509Certificates;
+
+namespace Communicate
+{
+    public class TlsSettings
+    {
+        private const SslProtocols Tls12 = (SslProtocols)3072;
+
+        public TlsSettings(X509Certificate certificate) : this(certificate, null, null)
+        {
+        }
+
+        public TlsSettings(X509Certificate certificate, string targetHost, RemoteCertificateValidationCallback validationCallback)
+        {
+            Certificate = certificate;
+            TargetHost = targetHost;
+            ValidationCallback = validationCallback;
+        }
+
+        public X509Certificate Certificate { get; }
+
+        // Without a target host a client validates the server against the peer's IP address, which
+        // certificates rarely name, so default validation fails unless a target host or callback is set.
+        public string TargetHost { get; }
+        public RemoteCertificateValidationCallback ValidationCallback { get; }
+
+        public SslProtocols EnabledProtocols { get; private set; } = Tls12;
+
+        public void SetEnabledProtocols(SslProtocols enabledProtocols)
+        {
+            if (enabledProtocols == SslProtocols.None)
+            {
+                throw new ArgumentOutOfRangeException(nameof(enabledProtocols), enabledProtocols, "The value for this property must enable at least one protocol");
+            }
+            EnabledProtocols = enabledProtocols;
+        }
+    }
+}
@@ -0,0 +1,162 @@
+﻿using System;
+using System.IO;
+using System.Net;
+using System.Net.Security;
+using System.Net.Sockets;
+using System.Security.Authentication;
+using System.Security.Cryptography.X509Certificates;
+
+namespace Communicate
+{
+    public class TlsTransport : ConnectionTransport
+    {
+        internal const int RecordSize = 16*1024;
+
+        private TlsTransport(ConnectionTransport innerTransport, SslStream stream)
+        {
+            InnerTransport = innerTransport;
+            Stream = stream;
+        }
+
+        public ConnectionTransport InnerTransport { get; }
+        private SslStream Stream { get; }
+
+        private byte[] RecordBuffer { get; } = new byte[RecordSize];
+        private int RecordBufferLength { get; set; }
+
+        public override bool Connected => InnerTransport.Connected;
+        public override EndPoint RemoteEndPoint => InnerTransport.RemoteEndPoint;
+        public override EndPoint LocalEndPoint => InnerTransport.LocalEndPoint;
+
+        internal static TlsTransport Authenticate(ConnectionTransport transport, TlsSettings settings, bool isServer)
+        {
+            if (transport == null)
+            {
+                throw new ArgumentNullException(nameof(transport));
+            }
+            if (settings == null)
+            {
+                throw new ArgumentNullException(nameof(settings));
+            }
+            if (isServer && settings.Certificate == null)
+            {
+                throw new AuthenticationException("A certificate is required to authenticate as a server");
+            }
+            if (isServer && (settings.Certificate as X509Certificate2)?.HasPrivateKey == false)
+            {
+                throw new AuthenticationException("The server certificate must have a private key");
+            }
+
+            var stream = new SslStream(new TransportStream(transport), false, settings.ValidationCallback);
+            try
+            {
+                if (isServer)
+                {
+                    stream.AuthenticateAsServer(settings.Certificate, false, settings.EnabledProtocols, false);
+                }
+                else
+                {
+                    var certificates = settings.Certificate != null ? new X509CertificateCollection(new[] { settings.Certificate }) : new X509CertificateCollection();
+                    stream.AuthenticateAsClient(TargetHostForTransport(transport, settings), certificates, settings.EnabledProtocols, false);
+                }
+            }
+            catch
+            {
+                stream.Dispose();
+                throw;
+            }
+            return new TlsTransport(transport, stream);
+        }
+
+        private static string TargetHostForTransport(ConnectionTransport transport, TlsSettings settings)
+        {
+            if (settings.TargetHost != null)
+            {
+                return settings.TargetHost;
+            }
+            return (transport.RemoteEndPoint as IPEndPoint)?.Address.ToString() ?? IPAddress.Loopback.ToString();
+        }
+
+        public override int Send(byte[] buffer, int offset, int count)
+        {
+            if (buffer == null)
+            {
+                throw new ArgumentNullException(nameof(buffer));
+            }
+
+            try
+            {
+                var remaining = count;
+                if (RecordBufferLength > 0)
+                {
+                    var length = Math.Min(remaining, RecordSize - RecordBufferLength);
+                    Buffer.BlockCopy(buffer, offset, RecordBuffer, RecordBufferLength, length);
+                    RecordBufferLength += length;
+                    offset += length;
+                    remaining -= length;
+
+                    if (RecordBufferLength < RecordSize)
+                    {
+                        return count;
+                    }
+                    Stream.Write(RecordBuffer, 0, RecordSize);
+                    RecordBufferLength = 0;
+                }
+
+                var recordsLength = remaining - remaining%RecordSize;
+                if (recordsLength > 0)
+                {
+                    Stream.Write(buffer, offset, recordsLength);
+                    offset += recordsLength;
+                    remaining -= recordsLength;
+                }
+
+                Buffer.BlockCopy(buffer, offset, RecordBuffer, 0, remaining);
+                RecordBufferLength = remaining;
+                return count;
+            }
+            catch (IOException exception)
+            {
+                throw TransportException(exception);
+            }
+        }
+
+        public override void Flush()
+        {
+            try
+            {
+                if (RecordBufferLength > 0)
+                {
+                    Stream.Write(RecordBuffer, 0, RecordBufferLength);
+                    RecordBufferLength = 0;
+                }
+                Stream.Flush();
+            }
+            catch (IOException exception)
+            {
+                throw TransportException(exception);
+            }
+        }
+
+        public override int Receive(byte[] buffer, int offset, int count)
+        {
+            try
+            {
+                return Stream.Read(buffer, offset, count);
+            }
+            catch (IOException exception)
+            {
+                throw TransportException(exception);
+            }
+        }
+
+        private static Exception TransportException(IOException exception) =>
+            exception.InnerException as SocketException ?? (Exception)new CommunicatorException(CommunicatorErrorCode.ConnectionClosed, exception);
+
+        public override void Close()
+        {
+            Stream.Dispose();
+            InnerTransport.Close();
+        }
+    }
+}
@@ -0,0 +1,60 @@
+﻿using System;
+using System.IO;
+
+namespace Communicate
+{
+    internal class TransportStream : Stream
+    {
+        internal TransportStream(ConnectionTransport transport)
+        {
+            if (transport == null)
+            {
+                throw new ArgumentNullException(nameof(transport));
+            }
+            Transport = transport;
+        }
+
+        private ConnectionTransport Transport { get; }
+
+        public override bool CanRead => true;
+        public override bool CanSeek => false;
+        public override bool CanWrite => true;
+
+        public override long Length
+        {
+            get { throw new NotSupportedException(); }
+        }
+
+        public override long Position
+        {
+            get { throw new NotSupportedException(); }
+            set { throw new NotSupportedException(); }
+        }
+
+        public override int Read(byte[] buffer, int offset, int count) => Transport.Receive(buffer, offset, count);
+
+        public override void Write(byte[] buffer, int offset, int count)
+        {
+            while (count > 0)
+            {
+                var sent = Transport.Send(buffer, offset, count);
+                offset += sent;
+                count -= sent;
+            }
+        }
+
+        public override void Flush()
+        {
+        }
+
+        public override long Seek(long offset, SeekOrigin origin)
+        {
+            throw new NotSupportedException();
+        }
+
+        public override void SetLength(long value)
+        {
+            throw new NotSupportedException();
+        }
+    }
+}
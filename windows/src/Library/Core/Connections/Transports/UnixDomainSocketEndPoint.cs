@@ -0,0 +1,64 @@
+﻿using System;
+using System.Net;
+using System.Net.Sockets;
+using System.Text;
+
+namespace Communicate
+{
+    public class UnixDomainSocketEndPoint : EndPoint
+    {
+        private const int PathOffset = 2;
+        private const int MaximumPathLength = 107;
+
+        public UnixDomainSocketEndPoint(string path)
+        {
+            if (path == null)
+            {
+                throw new ArgumentNullException(nameof(path));
+            }
+            if (Encoding.UTF8.GetByteCount(path) > MaximumPathLength)
+            {
+                throw new ArgumentOutOfRangeException(nameof(path), path, "The path must be at most " + MaximumPathLength + " bytes long");
+            }
+            Path = path;
+        }
+
+        public string Path { get; }
+
+        public override AddressFamily AddressFamily => AddressFamily.Unix;
+
+        public override SocketAddress Serialize()
+        {
+            var socketAddress = new SocketAddress(AddressFamily.Unix, PathOffset + MaximumPathLength + 1);
+            var pathBytes = Encoding.UTF8.GetBytes(Path);
+            for (var i = 0; i < pathBytes.Length; i++)
+            {
+                socketAddress[PathOffset + i] = pathBytes[i];
+            }
+            return socketAddress;
+        }
+
+        public override EndPoint Create(SocketAddress socketAddress)
+        {
+            if (socketAddress == null)
+            {
+                throw new ArgumentNullException(nameof(socketAddress));
+            }
+
+            var pathLength = 0;
+            while (PathOffset + pathLength < socketAddress.Size && socketAddress[PathOffset + pathLength] != 0)
+            {
+                pathLength++;
+            }
+
+            var pathBytes = new byte[pathLength];
+            for (var i = 0; i < pathLength; i++)
+            {
+                pathBytes[i] = socketAddress[PathOffset + i];
+            }
+            return new UnixDomainSocketEndPoint(Encoding.UTF8.GetString(pathBytes));
+        }
+
+        public override string ToString() => Path;
+    }
+}
@@ -0,0 +1,140 @@
+﻿using System;
+using System.IO;
+using System.Linq;
+using System.Net;
+using System.Net.Sockets;
+using System.Security.AccessControl;
+using System.Security.Principal;
+
+namespace Communicate
+{
+    internal static class UnixDomainTransport
+    {
+        private static readonly string SocketDirectory = Path.Combine(Environment.GetFolderPath(Environment.SpecialFolder.LocalApplicationData), "Communicate");
+
+        internal static string PathForPort(int port) => Path.Combine(SocketDirectory, "communicate-" + port + ".sock");
+
+        // Sockets live in a directory only the current user can access, so no other user can plant or replace one.
+        private static bool SecureSocketDirectory()
+        {
+            try
+            {
+                using (var identity = WindowsIdentity.GetCurrent())
+                {
+                    var security = new DirectorySecurity();
+                    security.SetAccessRuleProtection(true, false);
+                    security.AddAccessRule(new FileSystemAccessRule(identity.User, FileSystemRights.FullControl, InheritanceFlags.ContainerInherit | InheritanceFlags.ObjectInherit, PropagationFlags.None, AccessControlType.Allow));
+
+                    Directory.CreateDirectory(SocketDirectory);
+                    Directory.SetAccessControl(SocketDirectory, security);
+                }
+                return true;
+            }
+            catch (IOException)
+            {
+                return false;
+            }
+            catch (UnauthorizedAccessException)
+            {
+                return false;
+            }
+        }
+
+        internal static bool IsLocalAddress(IPAddress address)
+        {
+            if (address == null)
+            {
+                return false;
+            }
+            if (IPAddress.IsLoopback(address))
+            {
+                return true;
+            }
+
+            try
+            {
+                return Dns.GetHostAddresses(Dns.GetHostName()).Contains(address);
+            }
+            catch (SocketException)
+            {
+                return false;
+            }
+        }
+
+        internal static Socket Listen(int port)
+        {
+            if (!SecureSocketDirectory())
+            {
+                return null;
+            }
+
+            var path = PathForPort(port);
+            Socket socket = null;
+            try
+            {
+                File.Delete(path);
+
+                socket = new Socket(AddressFamily.Unix, SocketType.Stream, ProtocolType.Unspecified);
+                socket.Bind(new UnixDomainSocketEndPoint(path));
+                socket.Listen((int)SocketOptionName.MaxConnections);
+                return socket;
+            }
+            catch (SocketException)
+            {
+                socket?.Close();
+                return null;
+            }
+            catch (IOException)
+            {
+                socket?.Close();
+                return null;
+            }
+            catch (UnauthorizedAccessException)
+            {
+                socket?.Close();
+                return null;
+            }
+        }
+
+        internal static void StopListening(Socket socket, int port)
+        {
+            if (socket == null)
+            {
+                return;
+            }
+            socket.Close();
+            try
+            {
+                File.Delete(PathForPort(port));
+            }
+            catch (IOException)
+            {
+            }
+            catch (UnauthorizedAccessException)
+            {
+            }
+        }
+
+        internal static Socket TryConnect(IPEndPoint endPoint)
+        {
+            var path = PathForPort(endPoint.Port);
+            if (!IsLocalAddress(endPoint.Address) || !SecureSocketDirectory() || !File.Exists(path))
+            {
+                return null;
+            }
+
+            Socket socket = null;
+            try
+            {
+                socket = new Socket(AddressFamily.Unix, SocketType.Stream, ProtocolType.Unspecified);
+                socket.Connect(new UnixDomainSocketEndPoint(path));
+                return socket;
+            }
+            catch (SocketException)
+            {
+                socket?.Close();
+                return null;
+            }
+        }
+    }
+}
@@ -40,6 +40,11 @@ internal CommunicationData(DataInfo dataInfo)
         public DataHeaderFooter Footer { get; internal set; } = new DataHeaderFooter();
 
         internal byte[] InternalContent { get; set; }
+        internal string ContentFilePath { get; private set; }
+
+        private object FileContentLock { get; } = new object();
+        private byte[] FileContent { get; set; }
+        private DateTime FileContentWriteTime { get; set; }
         
         public CommunicationData WithHeader(DataHeaderFooter header)
         {
@@ -93,6 +98,8 @@ public CommunicationData WithContent(byte[] data, DataType type)
             }
 
             InternalContent = data;
+            ContentFilePath = null;
+            ClearFileContent();
             Info = new DataInfo(type);
             return this;
         }
@@ -141,8 +148,16 @@ public CommunicationData WithFilePath(string filePath)
             {
                 throw new FileNotFoundException("The file to serialize was not found", filePath);
             }
+            if (new FileInfo(filePath).Length > int.MaxValue)
+            {
+                throw new ArgumentException("The file is too large to be sent", nameof(filePath));
+            }
 
-            return Serialize(filePath, null, DataType.File);
+            InternalContent = null;
+            ContentFilePath = Path.GetFullPath(filePath);
+            ClearFileContent();
+            Info = new DataInfo(DataType.File);
+            return this;
         }
 
         public CommunicationData WithString(string value) => WithString(value, null);
@@ -301,10 +316,22 @@ public CommunicationData WithList(IList list, EncodedDataType encodedDataType)
         internal void PrepareForSending()
         {
             Info.HeaderLength = GetLength(Header.GetData());
-            Info.ContentLength = GetLength(InternalContent);
+            Info.ContentLength = ContentFilePath != null ? GetFileLength(ContentFilePath) : GetLength(InternalContent);
             Info.FooterLength = GetLength(Footer.GetData());
         }
 
+        // Known gap: frame lengths are 32-bit and files are not split across frames, so a file of 2 GB or
+        // more cannot be sent. Receivers also reject content above FrameLimits.MaximumContentLength.
+        private static int GetFileLength(string filePath)
+        {
+            var length = new FileInfo(filePath).Length;
+            if (length > int.MaxValue)
+            {
+                throw new IOException("The file is too large to be sent in a single frame");
+            }
+            return (int)length;
+        }
+
         private static int GetLength(ICollection<byte> data) => data?.Count ?? 0;
 
         public T GetObject<T>(DataType dataType)
@@ -317,7 +344,31 @@ public T GetObject<T>(DataType dataType)
             return dataType.Deserialize<T>(GetData(), null);
         }
 
-        public byte[] GetData() => InternalContent;
+        public byte[] GetData() => InternalContent ?? (ContentFilePath != null ? GetFileContent() : null);
+
+        // File-backed content is loaded once and reused until the file changes, so repeated calls while
+        // a frame is being sent or handled do not each read the whole file again.
+        private byte[] GetFileContent()
+        {
+            var file = new FileInfo(ContentFilePath);
+            lock (FileContentLock)
+            {
+                if (FileContent == null || !file.Exists || FileContent.Length != file.Length || FileContentWriteTime != file.LastWriteTimeUtc)
+                {
+                    FileContent = DataType.File.Serialize(ContentFilePath);
+                    FileContentWriteTime = file.LastWriteTimeUtc;
+                }
+                return FileContent;
+            }
+        }
+
+        private void ClearFileContent()
+        {
+            lock (FileContentLock)
+            {
+                FileContent = null;
+            }
+        }
 
         public string GetString() => GetString(null);
         public string GetString(Encoding encoding) => DataType.Text.Deserialize<string>(GetData(), encoding ?? Encoding.ASCII);
@@ -0,0 +1,298 @@
+﻿using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Security.Cryptography;
+
+namespace Communicate
+{
+    public class ContentCache
+    {
+        internal const string HashKey = "ContentHash";
+        internal const string QueryKey = "ContentQuery";
+
+        private const int HashLength = 64;
+
+        public ContentCache(long capacity) : this(capacity, null, 0)
+        {
+        }
+
+        public ContentCache(long capacity, string directory, long diskCapacity)
+        {
+            if (capacity < 0)
+            {
+                throw new ArgumentOutOfRangeException(nameof(capacity), capacity, "The capacity must not be negative");
+            }
+            if (directory != null && diskCapacity < 0)
+            {
+                throw new ArgumentOutOfRangeException(nameof(diskCapacity), diskCapacity, "The disk capacity must not be negative");
+            }
+
+            Capacity = capacity;
+            Directory = directory;
+            DiskCapacity = directory != null ? diskCapacity : 0;
+
+            if (Directory != null)
+            {
+                LoadDirectory();
+            }
+        }
+
+        public long Capacity { get; }
+        public string Directory { get; }
+        public long DiskCapacity { get; }
+
+        public int Threshold { get; private set; } = 64*1024;
+
+        public void SetThreshold(int threshold)
+        {
+            if (threshold < 0)
+            {
+                throw new ArgumentOutOfRangeException(nameof(threshold), threshold, "The value for this property must not be negative");
+            }
+            Threshold = threshold;
+        }
+
+        public long Hits { get; private set; }
+        public long Misses { get; private set; }
+        public long BytesSaved { get; private set; }
+
+        public double HitRate
+        {
+            get
+            {
+                lock (CacheLock)
+                {
+                    var lookups = Hits + Misses;
+                    return lookups == 0 ? 0 : (double)Hits/lookups;
+                }
+            }
+        }
+
+        private object CacheLock { get; } = new object();
+
+        private Dictionary<string, byte[]> MemoryEntries { get; } = new Dictionary<string, byte[]>();
+        private LruIndex MemoryIndex { get; } = new LruIndex();
+        private LruIndex DiskIndex { get; } = new LruIndex();
+
+        internal static string ComputeHash(byte[] content)
+        {
+            if (content == null)
+            {
+                throw new ArgumentNullException(nameof(content));
+            }
+
+            using (var algorithm = SHA256.Create())
+            {
+                return BitConverter.ToString(algorithm.ComputeHash(content)).Replace("-", "");
+            }
+        }
+
+        internal static bool IsValidHash(string hash) =>
+            hash != null && hash.Length == HashLength && hash.All(Uri.IsHexDigit);
+
+        internal bool TryGet(string hash, int length, out byte[] content)
+        {
+            content = null;
+            if (IsValidHash(hash))
+            {
+                lock (CacheLock)
+                {
+                    if (MemoryEntries.TryGetValue(hash, out content))
+                    {
+                        MemoryIndex.Touch(hash);
+                    }
+                    else if (DiskIndex.Contains(hash))
+                    {
+                        content = ReadFromDisk(hash);
+                        if (content != null)
+                        {
+                            AddToMemory(hash, content);
+                        }
+                    }
+
+                    if (content != null && content.Length != length)
+                    {
+                        content = null;
+                    }
+
+                    if (content != null)
+                    {
+                        content = (byte[])content.Clone();
+                        Hits++;
+                        BytesSaved += content.Length;
+                    }
+                    else
+                    {
+                        Misses++;
+                    }
+                }
+            }
+            return content != null;
+        }
+
+        internal void Add(string hash, byte[] content)
+        {
+            if (!IsValidHash(hash) || content == null)
+            {
+                return;
+            }
+
+            lock (CacheLock)
+            {
+                AddToMemory(hash, content);
+                if (Directory != null && content.Length <= DiskCapacity && !DiskIndex.Contains(hash))
+                {
+                    WriteToDisk(hash, content);
+                }
+            }
+        }
+
+        private void AddToMemory(string hash, byte[] content)
+        {
+            if (content.Length > Capacity)
+            {
+                return;
+            }
+            if (!MemoryEntries.ContainsKey(hash))
+            {
+                MemoryEntries.Add(hash, (byte[])content.Clone());
+                MemoryIndex.Add(hash, content.Length);
+            }
+            MemoryIndex.Touch(hash);
+
+            while (MemoryIndex.TotalSize > Capacity)
+            {
+                MemoryEntries.Remove(MemoryIndex.RemoveOldest());
+            }
+        }
+
+        private string PathForHash(string hash) => Path.Combine(Directory, hash);
+
+        private void LoadDirectory()
+        {
+            System.IO.Directory.CreateDirectory(Directory);
+
+            var files = new DirectoryInfo(Directory).GetFiles()
+                .Where(file => IsValidHash(file.Name))
+                .OrderBy(file => file.LastWriteTimeUtc);
+            foreach (var file in files)
+            {
+                DiskIndex.Add(file.Name, file.Length);
+            }
+            TrimDisk();
+        }
+
+        private byte[] ReadFromDisk(string hash)
+        {
+            try
+            {
+                var content = File.ReadAllBytes(PathForHash(hash));
+                if (!string.Equals(ComputeHash(content), hash, StringComparison.OrdinalIgnoreCase))
+                {
+                    DiskIndex.Remove(hash);
+                    File.Delete(PathForHash(hash));
+                    return null;
+                }
+                DiskIndex.Touch(hash);
+                return content;
+            }
+            catch (IOException)
+            {
+                DiskIndex.Remove(hash);
+                return null;
+            }
+            catch (UnauthorizedAccessException)
+            {
+                DiskIndex.Remove(hash);
+                return null;
+            }
+        }
+
+        private void WriteToDisk(string hash, byte[] content)
+        {
+            try
+            {
+                File.WriteAllBytes(PathForHash(hash), content);
+                DiskIndex.Add(hash, content.Length);
+                TrimDisk();
+            }
+            catch (IOException)
+            {
+            }
+            catch (UnauthorizedAccessException)
+            {
+            }
+        }
+
+        private void TrimDisk()
+        {
+            while (DiskIndex.TotalSize > DiskCapacity)
+            {
+                var hash = DiskIndex.RemoveOldest();
+                try
+                {
+                    File.Delete(PathForHash(hash));
+                }
+                catch (IOException)
+                {
+                }
+                catch (UnauthorizedAccessException)
+                {
+                }
+            }
+        }
+
+        private class LruIndex
+        {
+            private LinkedList<string> Order { get; } = new LinkedList<string>();
+            private Dictionary<string, LinkedListNode<string>> Nodes { get; } = new Dictionary<string, LinkedListNode<string>>();
+            private Dictionary<string, long> Sizes { get; } = new Dictionary<string, long>();
+
+            public long TotalSize { get; private set; }
+
+            public bool Contains(string key) => Nodes.ContainsKey(key);
+
+            public void Add(string key, long size)
+            {
+                if (Contains(key))
+                {
+                    Touch(key);
+                    return;
+                }
+                Nodes.Add(key, Order.AddLast(key));
+                Sizes.Add(key, size);
+                TotalSize += size;
+            }
+
+            public void Touch(string key)
+            {
+                LinkedListNode<string> node;
+                if (Nodes.TryGetValue(key, out node))
+                {
+                    Order.Remove(node);
+                    Order.AddLast(node);
+                }
+            }
+
+            public void Remove(string key)
+            {
+                LinkedListNode<string> node;
+                if (Nodes.TryGetValue(key, out node))
+                {
+                    Order.Remove(node);
+                    Nodes.Remove(key);
+                    TotalSize -= Sizes[key];
+                    Sizes.Remove(key);
+                }
+            }
+
+            public string RemoveOldest()
+            {
+                var key = Order.First.Value;
+                Remove(key);
+                return key;
+            }
+        }
+    }
+}
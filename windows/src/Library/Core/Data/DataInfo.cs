@@ -1,15 +1,15 @@
 ﻿using System;
-using System.Linq;
 
 namespace Communicate
 {
     internal class DataInfo
     {
-        internal DataInfo(byte[] bytes) : this(new DataType(BitConverter.ToInt32(bytes, 0)))
+        internal DataInfo(FrameHeader frameHeader) : this(new DataType(frameHeader.DataTypeIdentifier))
         {
-            HeaderLength = BitConverter.ToInt32(bytes, 4);
-            ContentLength = BitConverter.ToInt32(bytes, 8);
-            FooterLength = BitConverter.ToInt32(bytes, 12);
+            HeaderLength = frameHeader.HeaderLength;
+            ContentLength = frameHeader.ContentLength;
+            FooterLength = frameHeader.FooterLength;
+            Destination = frameHeader.Destination;
         }
 
         internal DataInfo(DataType dataType)
@@ -23,24 +23,18 @@ internal DataInfo(DataType dataType)
         public int ContentLength { get; internal set; }
         public int FooterLength { get; internal set; }
 
-        public static int DataInfoSize { get; } = 16;
+        public Guid Destination { get; internal set; }
 
-        public byte[] GetData() =>
-            Combine(DataType.GetBytes(),
-                    BitConverter.GetBytes(HeaderLength),
-                    BitConverter.GetBytes(ContentLength),
-                    BitConverter.GetBytes(FooterLength));
+        public static int DataInfoSize { get; } = FrameHeader.Size;
 
-        private static byte[] Combine(params byte[][] byteArrays)
+        internal FrameHeader GetFrameHeader() => new FrameHeader(DataType.Identifier, HeaderLength, ContentLength, FooterLength, Destination);
+
+        public byte[] GetData()
         {
-            var combined = new byte[byteArrays.Sum(a => a.Length)];
-            var offset = 0;
-            foreach (var array in byteArrays)
-            {
-                Buffer.BlockCopy(array, 0, combined, offset, array.Length);
-                offset += array.Length;
-            }
-            return combined;
+            var frameHeader = GetFrameHeader();
+            var data = new byte[frameHeader.Length];
+            frameHeader.Write(data, 0);
+            return data;
         }
     }
 }
\ No newline at end of file
@@ -74,6 +74,10 @@ private T PerformMethod<T>(string methodName, params object[] arguments)
 
         public bool IsSupported => !(IsKeyed);
 
+        public bool IsControl => IsControlIdentifier(Identifier);
+
+        internal static bool IsControlIdentifier(int identifier) => identifier == 0 || (identifier >= 100 && identifier <= 108);
+
         public static DataType Text => new DataType(1, "Text").Register(typeof(StringSerializer));
         public static DataType Image => new DataType(2, "Image").Register(typeof(ImageSerializer));
         public static DataType File => new DataType(3, "File").Register(typeof(FileSerializer));
@@ -103,6 +107,14 @@ private T PerformMethod<T>(string methodName, params object[] arguments)
 
         public static DataType Other => new DataType(99, "Other").Register();
         public static DataType ConnectionInformation => new DataType(100, "Connection Information").Register(typeof(InformationSerializer)).Register();
+        public static DataType TransferAccept => new DataType(101, "Transfer Accept").Register();
+        public static DataType ContentReply => new DataType(102, "Content Reply").Register();
+        public static DataType DatagramChannel => new DataType(103, "Datagram Channel").Register();
+        public static DataType Subscribe => new DataType(104, "Subscribe").Register();
+        public static DataType Unsubscribe => new DataType(105, "Unsubscribe").Register();
+        public static DataType RelayRoute => new DataType(106, "Relay Route").Register();
+        public static DataType TransferRequest => new DataType(107, "Transfer Request").Register();
+        public static DataType ContentQuery => new DataType(108, "Content Query").Register();
         public static DataType Termination => new DataType(0, "Termination").Register();
     }
 }
\ No newline at end of file
@@ -0,0 +1,103 @@
+﻿using System;
+
+namespace Communicate
+{
+    internal struct FrameHeader
+    {
+        internal const byte Magic = 0xC5;
+        internal const byte Version = 1;
+
+        internal const int Size = 20;
+        internal const int DestinationSize = 16;
+        internal const int MaximumSize = Size + DestinationSize;
+
+        private const ushort DestinationFlag = 0x0001;
+        private const ushort KnownFlags = DestinationFlag;
+
+        internal FrameHeader(int dataTypeIdentifier, int headerLength, int contentLength, int footerLength, Guid destination)
+            : this(destination != Guid.Empty ? DestinationFlag : (ushort)0, dataTypeIdentifier, headerLength, contentLength, footerLength, destination)
+        {
+        }
+
+        private FrameHeader(ushort flags, int dataTypeIdentifier, int headerLength, int contentLength, int footerLength, Guid destination)
+        {
+            Flags = flags;
+            DataTypeIdentifier = dataTypeIdentifier;
+            HeaderLength = headerLength;
+            ContentLength = contentLength;
+            FooterLength = footerLength;
+            Destination = destination;
+        }
+
+        public ushort Flags { get; }
+        public int DataTypeIdentifier { get; }
+        public int HeaderLength { get; }
+        public int ContentLength { get; }
+        public int FooterLength { get; }
+        public Guid Destination { get; }
+
+        public bool HasDestination => (Flags & DestinationFlag) != 0;
+        public int Length => HasDestination ? MaximumSize : Size;
+
+        public long BodyLength => (long)HeaderLength + ContentLength + FooterLength;
+
+        internal static bool TryRead(byte[] buffer, int offset, out FrameHeader frameHeader)
+        {
+            frameHeader = default(FrameHeader);
+            if (buffer == null || offset < 0 || buffer.Length - offset < Size)
+            {
+                return false;
+            }
+            var flags = ReadUInt16(buffer, offset + 2);
+            if (buffer[offset] != Magic || buffer[offset + 1] != Version || (flags & ~KnownFlags) != 0)
+            {
+                return false;
+            }
+
+            frameHeader = new FrameHeader(flags, ReadInt32(buffer, offset + 4), ReadInt32(buffer, offset + 8), ReadInt32(buffer, offset + 12), ReadInt32(buffer, offset + 16), Guid.Empty);
+            return frameHeader.HeaderLength >= 0 && frameHeader.ContentLength >= 0 && frameHeader.FooterLength >= 0;
+        }
+
+        internal FrameHeader WithDestination(byte[] buffer, int offset)
+        {
+            var destination = new byte[DestinationSize];
+            Buffer.BlockCopy(buffer, offset, destination, 0, DestinationSize);
+            return new FrameHeader(Flags, DataTypeIdentifier, HeaderLength, ContentLength, FooterLength, new Guid(destination));
+        }
+
+        internal void Write(byte[] buffer, int offset)
+        {
+            buffer[offset] = Magic;
+            buffer[offset + 1] = Version;
+            WriteUInt16(buffer, offset + 2, Flags);
+            WriteInt32(buffer, offset + 4, DataTypeIdentifier);
+            WriteInt32(buffer, offset + 8, HeaderLength);
+            WriteInt32(buffer, offset + 12, ContentLength);
+            WriteInt32(buffer, offset + 16, FooterLength);
+            if (HasDestination)
+            {
+                Buffer.BlockCopy(Destination.ToByteArray(), 0, buffer, offset + Size, DestinationSize);
+            }
+        }
+
+        private static ushort ReadUInt16(byte[] buffer, int offset) =>
+            (ushort)(buffer[offset] | buffer[offset + 1] << 8);
+
+        private static int ReadInt32(byte[] buffer, int offset) =>
+            buffer[offset] | buffer[offset + 1] << 8 | buffer[offset + 2] << 16 | buffer[offset + 3] << 24;
+
+        private static void WriteUInt16(byte[] buffer, int offset, ushort value)
+        {
+            buffer[offset] = (byte)value;
+            buffer[offset + 1] = (byte)(value >> 8);
+        }
+
+        private static void WriteInt32(byte[] buffer, int offset, int value)
+        {
+            buffer[offset] = (byte)value;
+            buffer[offset + 1] = (byte)(value >> 8);
+            buffer[offset + 2] = (byte)(value >> 16);
+            buffer[offset + 3] = (byte)(value >> 24);
+        }
+    }
+}
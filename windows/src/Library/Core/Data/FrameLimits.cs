@@ -0,0 +1,98 @@
+﻿using System;
+using System.Collections.Generic;
+
+namespace Communicate
+{
+    public class FrameLimits
+    {
+        private const int ControlContentLength = 64*1024;
+
+        public int MaximumHeaderLength { get; private set; } = 64*1024;
+        public int MaximumFooterLength { get; private set; } = 64*1024;
+        public int MaximumContentLength { get; private set; } = 256*1024*1024;
+        public int MaximumDatagramLength { get; private set; } = 1024*1024;
+
+        private object LimitsLock { get; } = new object();
+        private Dictionary<int, int> MaximumContentLengths { get; } = new Dictionary<int, int>();
+
+        public void SetMaximumHeaderLength(int maximumHeaderLength)
+        {
+            if (maximumHeaderLength < 0)
+            {
+                throw new ArgumentOutOfRangeException(nameof(maximumHeaderLength), maximumHeaderLength, "The value for this property must not be negative");
+            }
+            MaximumHeaderLength = maximumHeaderLength;
+        }
+
+        public void SetMaximumFooterLength(int maximumFooterLength)
+        {
+            if (maximumFooterLength < 0)
+            {
+                throw new ArgumentOutOfRangeException(nameof(maximumFooterLength), maximumFooterLength, "The value for this property must not be negative");
+            }
+            MaximumFooterLength = maximumFooterLength;
+        }
+
+        public void SetMaximumContentLength(int maximumContentLength)
+        {
+            if (maximumContentLength < 0)
+            {
+                throw new ArgumentOutOfRangeException(nameof(maximumContentLength), maximumContentLength, "The value for this property must not be negative");
+            }
+            MaximumContentLength = maximumContentLength;
+        }
+
+        public void SetMaximumDatagramLength(int maximumDatagramLength)
+        {
+            const int maximumLength = ushort.MaxValue*DatagramChannel.MaximumFragmentSize;
+            if (maximumDatagramLength < 1 || maximumDatagramLength > maximumLength)
+            {
+                throw new ArgumentOutOfRangeException(nameof(maximumDatagramLength), maximumDatagramLength, "The value for this property must be between 1 and " + maximumLength);
+            }
+            MaximumDatagramLength = maximumDatagramLength;
+        }
+
+        public void SetMaximumContentLength(DataType dataType, int maximumContentLength)
+        {
+            if (dataType == null)
+            {
+                throw new ArgumentNullException(nameof(dataType));
+            }
+            if (maximumContentLength < 0)
+            {
+                throw new ArgumentOutOfRangeException(nameof(maximumContentLength), maximumContentLength, "The value for this property must not be negative");
+            }
+            lock (LimitsLock)
+            {
+                MaximumContentLengths[dataType.Identifier] = maximumContentLength;
+            }
+        }
+
+        public int MaximumContentLengthForDataType(DataType dataType)
+        {
+            if (dataType == null)
+            {
+                throw new ArgumentNullException(nameof(dataType));
+            }
+            return MaximumContentLengthForIdentifier(dataType.Identifier);
+        }
+
+        private int MaximumContentLengthForIdentifier(int identifier)
+        {
+            lock (LimitsLock)
+            {
+                int maximumContentLength;
+                if (MaximumContentLengths.TryGetValue(identifier, out maximumContentLength))
+                {
+                    return maximumContentLength;
+                }
+                return DataType.IsControlIdentifier(identifier) ? ControlContentLength : MaximumContentLength;
+            }
+        }
+
+        internal bool Allows(FrameHeader frameHeader) =>
+            frameHeader.HeaderLength <= MaximumHeaderLength &&
+            frameHeader.FooterLength <= MaximumFooterLength &&
+            frameHeader.ContentLength <= MaximumContentLengthForIdentifier(frameHeader.DataTypeIdentifier);
+    }
+}
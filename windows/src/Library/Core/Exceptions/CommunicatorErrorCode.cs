@@ -26,6 +26,11 @@ public enum CommunicatorErrorCode
         ConnectionRejected,
         ConnectionClosed,
         ConnectionSocketCreationError,
-        ConnectionUnknownError
+        ConnectionUnknownError,
+        ConnectionTransferTimedOut,
+        ConnectionTransferFailed,
+        ConnectionInvalidFrame,
+        ConnectionAuthenticationFailed,
+        ConnectionEncodingFailed
     }
 }
@@ -1,5 +1,6 @@
 ﻿using System;
 using System.Reflection;
+using System.Runtime.CompilerServices;
 using System.Runtime.InteropServices;
 
 // General Information about an assembly is controlled through the following 
@@ -21,6 +22,7 @@
 
 [assembly: ComVisible(false)]
 [assembly: CLSCompliant(true)]
+[assembly: InternalsVisibleTo("Communicate.Tests, PublicKey=002400000480000094000000060200000024000052534131000400000100010037db22c7b0ee90ade72bfc166e44c4ef3d9ad5c40858c0a92ddb2be051705bb89d13ad67e2509c73376272eaaef40ba6b54a49452fd8aa65b4456a25cce5e4da39d521af8a5c69d4dc9d3f4edb8efe29a7a6a8e3351f9f3dff24f480e2b95ac10cd67a2ceda54e59c45bc94d7b062df3befc927b12989b87038fa386544dd2d1")]
 
 // The following GUID is for the ID of the typelib if this project is exposed to COM
 
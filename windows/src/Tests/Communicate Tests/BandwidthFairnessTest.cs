@@ -0,0 +1,116 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Linq;
+using System.Threading;
+
+namespace Communicate.Tests
+{
+    internal static class BandwidthFairnessTest
+    {
+        private const long BandwidthLimit = 4*1024*1024;
+        private const int ContentLength = 3*1024*1024;
+        private const int LightWeight = 1;
+        private const int HeavyWeight = 3;
+        private static readonly TimeSpan Timeout = TimeSpan.FromSeconds(20);
+
+        internal static bool Run()
+        {
+            Console.WriteLine("Sharing {0} MB/s between in-memory connections weighted {1} and {2}", BandwidthLimit/(1024*1024), LightWeight, HeavyWeight);
+
+            var sender = new TestCommunicator(0);
+            var lightReceiver = new TestCommunicator(0);
+            var heavyReceiver = new TestCommunicator(0);
+            var lightConnection = ConnectInMemory(sender, lightReceiver);
+            var heavyConnection = ConnectInMemory(sender, heavyReceiver);
+            if (lightConnection == null || heavyConnection == null)
+            {
+                Console.WriteLine("Failure: the in-memory connections were not established");
+                return false;
+            }
+
+            lightConnection.SetBandwidthWeight(LightWeight);
+            heavyConnection.SetBandwidthWeight(HeavyWeight);
+            sender.SetBandwidthLimit(BandwidthLimit);
+
+            // Both sends run on pool threads that sleep while throttled, so make sure the second one
+            // does not wait for the pool to grow before it starts.
+            int workerThreads;
+            int completionPortThreads;
+            ThreadPool.GetMinThreads(out workerThreads, out completionPortThreads);
+            ThreadPool.SetMinThreads(Math.Max(workerThreads, 16), completionPortThreads);
+
+            var stopwatch = Stopwatch.StartNew();
+            var lightReceived = WatchForContent(lightReceiver);
+            var heavyReceived = WatchForContent(heavyReceiver);
+            lightConnection.Send(new CommunicationData().WithData(new byte[ContentLength]));
+            heavyConnection.Send(new CommunicationData().WithData(new byte[ContentLength]));
+
+            if (!heavyReceived.WaitOne(Timeout))
+            {
+                Console.WriteLine("Failure: the heavier connection did not deliver its content");
+                return false;
+            }
+            var heavyElapsed = stopwatch.Elapsed;
+            if (!lightReceived.WaitOne(Timeout))
+            {
+                Console.WriteLine("Failure: the lighter connection did not deliver its content");
+                return false;
+            }
+            var lightElapsed = stopwatch.Elapsed;
+
+            // The heavier connection gets three quarters of the limit until it finishes, so it should
+            // need about two thirds of the time the lighter one needs for the same content.
+            var failures = new List<string>();
+            var ratio = heavyElapsed.TotalMilliseconds/lightElapsed.TotalMilliseconds;
+            if (ratio > 0.8)
+            {
+                failures.Add(string.Format("The heavier connection finished at {0:F2} of the lighter one's time instead of about 0.67", ratio));
+            }
+            var minimumElapsed = TimeSpan.FromSeconds(0.8*2*ContentLength/BandwidthLimit);
+            if (lightElapsed < minimumElapsed)
+            {
+                failures.Add(string.Format("Both connections finished in {0} ms, faster than the limit allows", (long)lightElapsed.TotalMilliseconds));
+            }
+
+            Console.WriteLine("Weight {0}: {1} ms, weight {2}: {3} ms ({4:F2} of the lighter time)", LightWeight, (long)lightElapsed.TotalMilliseconds, HeavyWeight, (long)heavyElapsed.TotalMilliseconds, ratio);
+            sender.Connections.DisconnectAll(true);
+            foreach (var failure in failures)
+            {
+                Console.WriteLine("Failure: " + failure);
+            }
+            return failures.Count == 0;
+        }
+
+        private static Connection ConnectInMemory(BaseCommunicator sender, BaseCommunicator receiver)
+        {
+            var existing = new HashSet<Guid>(sender.Connections.ToSnapshot().Select(connection => connection.Identifier));
+            sender.ConnectInMemory(receiver, null);
+
+            var deadline = DateTime.UtcNow + Timeout;
+            while (DateTime.UtcNow < deadline)
+            {
+                var connection = sender.Connections.ToSnapshot().FirstOrDefault(candidate => !existing.Contains(candidate.Identifier) && candidate.State == ConnectionState.Connected);
+                if (connection != null)
+                {
+                    return connection;
+                }
+                Thread.Sleep(10);
+            }
+            return null;
+        }
+
+        private static ManualResetEvent WatchForContent(BaseCommunicator receiver)
+        {
+            var received = new ManualResetEvent(false);
+            receiver.DidUpdateReceivingData += (communicator, dataArgs) =>
+            {
+                if (dataArgs.Component == DataComponent.All && dataArgs.DataState == ActionState.Completed)
+                {
+                    received.Set();
+                }
+            };
+            return received;
+        }
+    }
+}
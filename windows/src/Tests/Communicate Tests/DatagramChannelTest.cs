@@ -0,0 +1,195 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Net;
+using System.Net.Sockets;
+using System.Text;
+using System.Threading;
+
+namespace Communicate.Tests
+{
+    internal static class DatagramChannelTest
+    {
+        internal const int DefaultSeed = 29;
+
+        private const int MessageCount = 200;
+        private const double SimulatedLossRate = 0.05;
+        private const int FragmentHeaderSize = 8;
+        private static readonly TimeSpan DeliveryTimeout = TimeSpan.FromSeconds(2);
+
+        internal static bool Run(int seed)
+        {
+            Console.WriteLine("Sending datagrams over loopback with simulated loss (seed {0})", seed);
+            return RunSimulatedLoss(seed) && RunInjectedFragments();
+        }
+
+        private static bool RunSimulatedLoss(int seed)
+        {
+            var failures = new List<string>();
+            using (var sender = new DatagramChannel(IPAddress.Loopback))
+            using (var receiver = new DatagramChannel(IPAddress.Loopback))
+            {
+                sender.Open(receiver.LocalPort);
+                receiver.Open(sender.LocalPort);
+                sender.SetSimulatedLoss(SimulatedLossRate, seed);
+
+                var delivered = new List<int>();
+                receiver.DidReceiveData += (channel, dataArgs) =>
+                {
+                    lock (delivered)
+                    {
+                        delivered.Add(BitConverter.ToInt32(dataArgs.Data.GetData(), 0));
+                    }
+                };
+
+                var random = new Random(seed);
+                var expectedDelivered = new List<int>();
+                var expectedDropped = 0;
+                for (var i = 0; i < MessageCount; i++)
+                {
+                    var content = new byte[i%4 == 0 ? 3*DatagramChannel.MaximumFragmentSize : 16];
+                    Buffer.BlockCopy(BitConverter.GetBytes(i), 0, content, 0, 4);
+                    var data = new CommunicationData().WithData(content);
+
+                    var fragmentCount = FragmentCount(data);
+                    var fragmentsLost = Enumerable.Range(0, fragmentCount).Count(fragment => random.NextDouble() < SimulatedLossRate);
+                    if (fragmentsLost == 0)
+                    {
+                        expectedDelivered.Add(i);
+                    }
+                    else if (fragmentsLost < fragmentCount)
+                    {
+                        expectedDropped++;
+                    }
+
+                    sender.Send(data);
+                    Thread.Sleep(1);
+                }
+
+                WaitFor(() => { lock (delivered) { return delivered.Count >= expectedDelivered.Count; } });
+                Thread.Sleep(receiver.ReassemblyTimeout + receiver.ReassemblyTimeout);
+
+                lock (delivered)
+                {
+                    if (!delivered.SequenceEqual(expectedDelivered))
+                    {
+                        failures.Add(string.Format("{0} messages were delivered but {1} were expected in order", delivered.Count, expectedDelivered.Count));
+                    }
+                }
+                Expect(failures, "MessagesSent", sender.MessagesSent, MessageCount);
+                Expect(failures, "MessagesReceived", receiver.MessagesReceived, expectedDelivered.Count);
+                Expect(failures, "MessagesDropped", receiver.MessagesDropped, expectedDropped);
+                Expect(failures, "MessagesStale", receiver.MessagesStale, 0);
+                Expect(failures, "FragmentsReordered", receiver.FragmentsReordered, 0);
+
+                Console.WriteLine("Simulated loss: {0} of {1} messages delivered, {2} dropped", receiver.MessagesReceived, MessageCount, receiver.MessagesDropped);
+            }
+            return Check(failures);
+        }
+
+        private static bool RunInjectedFragments()
+        {
+            var failures = new List<string>();
+            using (var receiver = new DatagramChannel(IPAddress.Loopback))
+            using (var peer = new Socket(AddressFamily.InterNetwork, SocketType.Dgram, ProtocolType.Udp))
+            {
+                peer.Bind(new IPEndPoint(IPAddress.Loopback, 0));
+                receiver.Open(((IPEndPoint)peer.LocalEndPoint).Port);
+                var target = new IPEndPoint(IPAddress.Loopback, receiver.LocalPort);
+
+                var delivered = new List<int>();
+                receiver.DidReceiveData += (channel, dataArgs) =>
+                {
+                    lock (delivered)
+                    {
+                        delivered.Add(BitConverter.ToInt32(dataArgs.Data.GetData(), 0));
+                    }
+                };
+
+                var reordered = CreateMessage(2, "", DatagramChannel.MaximumFragmentSize);
+                SendFragment(peer, target, 2, 1, 2, reordered);
+                SendFragment(peer, target, 2, 0, 2, reordered);
+                SendFragment(peer, target, 1, 0, 1, CreateMessage(1, "", 4));
+                SendFragment(peer, target, 3, 0, 1, CreateMessage(3, "{", 4));
+                SendFragment(peer, target, 4, 0, 2, CreateMessage(4, "", DatagramChannel.MaximumFragmentSize));
+                SendFragment(peer, target, 5, 0, 1, CreateMessage(5, "", 4));
+
+                WaitFor(() => receiver.MessagesReceived + receiver.MessagesDropped + receiver.MessagesStale >= 5);
+
+                lock (delivered)
+                {
+                    if (!delivered.SequenceEqual(new[] { 2, 5 }))
+                    {
+                        failures.Add("Delivered messages " + string.Join(", ", delivered) + " instead of 2, 5");
+                    }
+                }
+                Expect(failures, "MessagesReceived", receiver.MessagesReceived, 2);
+                Expect(failures, "MessagesDropped", receiver.MessagesDropped, 2);
+                Expect(failures, "MessagesStale", receiver.MessagesStale, 1);
+                Expect(failures, "FragmentsReordered", receiver.FragmentsReordered, 1);
+
+                Console.WriteLine("Injected fragments: {0} delivered, {1} dropped, {2} stale, {3} reordered", receiver.MessagesReceived, receiver.MessagesDropped, receiver.MessagesStale, receiver.FragmentsReordered);
+            }
+            return Check(failures);
+        }
+
+        private static int FragmentCount(CommunicationData data)
+        {
+            data.PrepareForSending();
+            var length = data.Info.GetData().Length + data.Header.GetData().Length + data.GetData().Length + data.Footer.GetData().Length;
+            return (length + DatagramChannel.MaximumFragmentSize - 1)/DatagramChannel.MaximumFragmentSize;
+        }
+
+        private static byte[] CreateMessage(int messageIdentifier, string header, int contentLength)
+        {
+            var headerData = Encoding.ASCII.GetBytes(header);
+            var frameHeader = new FrameHeader(DataType.Other.Identifier, headerData.Length, contentLength, 0, Guid.Empty);
+
+            var message = new byte[frameHeader.Length + headerData.Length + contentLength];
+            frameHeader.Write(message, 0);
+            Buffer.BlockCopy(headerData, 0, message, frameHeader.Length, headerData.Length);
+            Buffer.BlockCopy(BitConverter.GetBytes(messageIdentifier), 0, message, frameHeader.Length + headerData.Length, 4);
+            return message;
+        }
+
+        private static void SendFragment(Socket peer, EndPoint target, uint messageIdentifier, ushort fragmentIndex, ushort fragmentCount, byte[] message)
+        {
+            var offset = fragmentIndex*DatagramChannel.MaximumFragmentSize;
+            var length = Math.Min(DatagramChannel.MaximumFragmentSize, message.Length - offset);
+
+            var datagram = new byte[FragmentHeaderSize + length];
+            Buffer.BlockCopy(BitConverter.GetBytes(messageIdentifier), 0, datagram, 0, 4);
+            Buffer.BlockCopy(BitConverter.GetBytes(fragmentIndex), 0, datagram, 4, 2);
+            Buffer.BlockCopy(BitConverter.GetBytes(fragmentCount), 0, datagram, 6, 2);
+            Buffer.BlockCopy(message, offset, datagram, FragmentHeaderSize, length);
+            peer.SendTo(datagram, target);
+            Thread.Sleep(10);
+        }
+
+        private static void WaitFor(Func<bool> condition)
+        {
+            var deadline = DateTime.UtcNow + DeliveryTimeout;
+            while (!condition() && DateTime.UtcNow < deadline)
+            {
+                Thread.Sleep(10);
+            }
+        }
+
+        private static void Expect(List<string> failures, string counter, long actual, long expected)
+        {
+            if (actual != expected)
+            {
+                failures.Add(string.Format("{0} was {1} instead of {2}", counter, actual, expected));
+            }
+        }
+
+        private static bool Check(List<string> failures)
+        {
+            foreach (var failure in failures)
+            {
+                Console.WriteLine("Failure: " + failure);
+            }
+            return failures.Count == 0;
+        }
+    }
+}
@@ -0,0 +1,141 @@
+﻿using System;
+using System.Diagnostics;
+using System.Linq;
+using System.Net;
+using System.Net.Sockets;
+using System.Threading;
+
+namespace Communicate.Tests
+{
+    internal static class ParallelTransferBenchmark
+    {
+        private const int ContentLength = 8*1024*1024;
+        private const int ChunkSize = 64*1024;
+        private const int WindowSize = 64*1024;
+        private static readonly TimeSpan Latency = TimeSpan.FromMilliseconds(5);
+        private static readonly int[] StreamCounts = { 1, 2, 4, 8 };
+
+        internal static bool Run()
+        {
+            Console.WriteLine("Striping {0} MB over loopback with {1} ms added per {2} KB window", ContentLength/(1024*1024), Latency.TotalMilliseconds, WindowSize/1024);
+
+            var content = new byte[ContentLength];
+            new Random(ContentLength).NextBytes(content);
+
+            double? singleStreamThroughput = null;
+            foreach (var streamCount in StreamCounts)
+            {
+                var received = new byte[ContentLength];
+                TimeSpan elapsed;
+                var failure = Transfer(streamCount, content, received, out elapsed);
+                if (failure == null && !received.SequenceEqual(content))
+                {
+                    failure = "The received content does not match the sent content";
+                }
+                if (failure != null)
+                {
+                    Console.WriteLine("Failure with {0} streams: {1}", streamCount, failure);
+                    return false;
+                }
+
+                var throughput = ContentLength/(1024.0*1024.0)/elapsed.TotalSeconds;
+                singleStreamThroughput = singleStreamThroughput ?? throughput;
+                Console.WriteLine("{0,2} streams: {1,6} ms, {2,7:F1} MB/s ({3:F1}x)", streamCount, (long)elapsed.TotalMilliseconds, throughput, throughput/singleStreamThroughput);
+            }
+            return true;
+        }
+
+        private static string Transfer(int streamCount, byte[] content, byte[] received, out TimeSpan elapsed)
+        {
+            var transfer = new ParallelTransfer(Guid.NewGuid(), streamCount);
+            var listener = new TcpListener(IPAddress.Loopback, 0);
+            var proxy = new TcpListener(IPAddress.Loopback, 0);
+            listener.Start();
+            proxy.Start();
+
+            Exception receiveException = null;
+            var receiver = new Thread(() =>
+            {
+                try
+                {
+                    transfer.Receive(listener, IPAddress.Loopback, received, ChunkSize, null);
+                }
+                catch (Exception exception)
+                {
+                    receiveException = exception;
+                }
+            }) { IsBackground = true };
+            var forwarder = new Thread(() => ForwardWithLatency(proxy, (IPEndPoint)listener.LocalEndpoint, streamCount)) { IsBackground = true };
+
+            var stopwatch = Stopwatch.StartNew();
+            try
+            {
+                receiver.Start();
+                forwarder.Start();
+                transfer.Send((IPEndPoint)proxy.LocalEndpoint, content, ChunkSize, null);
+                receiver.Join();
+                return receiveException?.Message;
+            }
+            catch (CommunicatorException exception)
+            {
+                return exception.Message;
+            }
+            finally
+            {
+                elapsed = stopwatch.Elapsed;
+                listener.Stop();
+                proxy.Stop();
+            }
+        }
+
+        private static void ForwardWithLatency(TcpListener proxy, IPEndPoint destination, int connectionCount)
+        {
+            try
+            {
+                for (var i = 0; i < connectionCount; i++)
+                {
+                    var source = proxy.AcceptSocket();
+                    new Thread(() => Forward(source, destination)) { IsBackground = true }.Start();
+                }
+            }
+            catch (SocketException)
+            {
+            }
+            catch (ObjectDisposedException)
+            {
+            }
+        }
+
+        private static void Forward(Socket source, IPEndPoint destination)
+        {
+            var window = new byte[WindowSize];
+            using (source)
+            using (var target = new Socket(destination.AddressFamily, SocketType.Stream, ProtocolType.Tcp))
+            {
+                try
+                {
+                    target.Connect(destination);
+                    while (true)
+                    {
+                        var read = source.Receive(window);
+                        if (read <= 0)
+                        {
+                            target.Shutdown(SocketShutdown.Send);
+                            return;
+                        }
+
+                        Thread.Sleep(Latency);
+                        var sent = 0;
+                        while (sent < read)
+                        {
+                            sent += target.Send(window, sent, read - sent, SocketFlags.None);
+                        }
+                    }
+                }
+                catch (SocketException)
+                {
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,172 @@
+﻿using System;
+using System.Diagnostics;
+
+namespace Communicate.Tests
+{
+    internal static class ParserFuzzer
+    {
+        private const int MaximumInputLength = FrameHeader.MaximumSize + 8;
+
+        internal static bool Run(int iterations, int seed)
+        {
+            Console.WriteLine("Fuzzing the frame parser with {0} inputs (seed {1})", iterations, seed);
+
+            var random = new Random(seed);
+            var frameLimits = new FrameLimits();
+            var seedFrames = CreateSeedFrames(random);
+            var parsed = 0;
+            var allowed = 0;
+
+            for (var i = 0; i < iterations; i++)
+            {
+                var input = i%2 == 0 ? CreateRandomInput(random) : Mutate(seedFrames[random.Next(seedFrames.Length)], random);
+                try
+                {
+                    FrameHeader frameHeader;
+                    if (!FrameHeader.TryRead(input, 0, out frameHeader))
+                    {
+                        continue;
+                    }
+                    parsed++;
+
+                    if (frameHeader.HeaderLength < 0 || frameHeader.ContentLength < 0 || frameHeader.FooterLength < 0)
+                    {
+                        return Fail("TryRead accepted a negative length", input);
+                    }
+                    if (frameHeader.HasDestination && input.Length >= FrameHeader.MaximumSize)
+                    {
+                        frameHeader = frameHeader.WithDestination(input, FrameHeader.Size);
+                    }
+                    if (!RoundTrips(frameHeader, input))
+                    {
+                        return Fail("The parsed frame header does not round trip", input);
+                    }
+
+                    if (frameLimits.Allows(frameHeader))
+                    {
+                        allowed++;
+                        if (frameHeader.HeaderLength > frameLimits.MaximumHeaderLength || frameHeader.FooterLength > frameLimits.MaximumFooterLength || frameHeader.ContentLength > frameLimits.MaximumContentLength)
+                        {
+                            return Fail("FrameLimits allowed a frame over the limits", input);
+                        }
+                    }
+                }
+                catch (Exception exception)
+                {
+                    return Fail(exception.GetType().Name + ": " + exception.Message, input);
+                }
+            }
+
+            Console.WriteLine("{0} inputs parsed, {1} allowed by the default limits", parsed, allowed);
+            return true;
+        }
+
+        internal static void Benchmark(int iterations)
+        {
+            var frameLimits = new FrameLimits();
+            var buffer = new byte[FrameHeader.MaximumSize];
+            new FrameHeader(DataType.Other.Identifier, 64, 1024, 0, Guid.NewGuid()).Write(buffer, 0);
+
+            var accepted = 0;
+            var stopwatch = Stopwatch.StartNew();
+            for (var i = 0; i < iterations; i++)
+            {
+                FrameHeader frameHeader;
+                if (FrameHeader.TryRead(buffer, 0, out frameHeader) && frameLimits.Allows(frameHeader.WithDestination(buffer, FrameHeader.Size)))
+                {
+                    accepted++;
+                }
+            }
+            stopwatch.Stop();
+
+            Console.WriteLine("Parsed {0} frame headers in {1} ms ({2:F1} ns per header)", accepted, stopwatch.ElapsedMilliseconds, stopwatch.Elapsed.TotalMilliseconds*1000000/Math.Max(iterations, 1));
+        }
+
+        private static byte[][] CreateSeedFrames(Random random)
+        {
+            var destination = new byte[FrameHeader.DestinationSize];
+            random.NextBytes(destination);
+
+            var frameHeaders = new[]
+            {
+                new FrameHeader(DataType.Other.Identifier, 0, 0, 0, Guid.Empty),
+                new FrameHeader(DataType.Text.Identifier, 128, 4096, 16, Guid.Empty),
+                new FrameHeader(DataType.Termination.Identifier, 0, 0, 0, Guid.Empty),
+                new FrameHeader(DataType.ContentReply.Identifier, 64, 1, 0, Guid.Empty),
+                new FrameHeader(DataType.Other.Identifier, 64*1024, 256*1024*1024, 64*1024, new Guid(destination))
+            };
+
+            var seedFrames = new byte[frameHeaders.Length][];
+            for (var i = 0; i < frameHeaders.Length; i++)
+            {
+                seedFrames[i] = new byte[frameHeaders[i].Length];
+                frameHeaders[i].Write(seedFrames[i], 0);
+            }
+            return seedFrames;
+        }
+
+        private static byte[] CreateRandomInput(Random random)
+        {
+            var input = new byte[random.Next(MaximumInputLength + 1)];
+            random.NextBytes(input);
+            if (input.Length >= 2 && random.Next(2) == 0)
+            {
+                input[0] = FrameHeader.Magic;
+                input[1] = FrameHeader.Version;
+            }
+            return input;
+        }
+
+        private static byte[] Mutate(byte[] seedFrame, Random random)
+        {
+            var length = random.Next(4) == 0 ? random.Next(seedFrame.Length + 1) : seedFrame.Length;
+            var input = new byte[length];
+            Buffer.BlockCopy(seedFrame, 0, input, 0, length);
+            if (length == 0)
+            {
+                return input;
+            }
+
+            var mutations = random.Next(1, 4);
+            for (var i = 0; i < mutations; i++)
+            {
+                var index = random.Next(length);
+                switch (random.Next(3))
+                {
+                    case 0:
+                        input[index] ^= (byte)(1 << random.Next(8));
+                        break;
+                    case 1:
+                        input[index] = (byte)random.Next(256);
+                        break;
+                    default:
+                        input[index] = random.Next(2) == 0 ? (byte)0x00 : (byte)0xFF;
+                        break;
+                }
+            }
+            return input;
+        }
+
+        private static bool RoundTrips(FrameHeader frameHeader, byte[] input)
+        {
+            var written = new byte[FrameHeader.MaximumSize];
+            frameHeader.Write(written, 0);
+            var length = input.Length >= frameHeader.Length ? frameHeader.Length : FrameHeader.Size;
+            for (var i = 0; i < length; i++)
+            {
+                if (written[i] != input[i])
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        private static bool Fail(string message, byte[] input)
+        {
+            Console.WriteLine("Failure: " + message);
+            Console.WriteLine("Input: " + BitConverter.ToString(input));
+            return false;
+        }
+    }
+}
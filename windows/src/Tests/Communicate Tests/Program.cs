@@ -0,0 +1,76 @@
+﻿using System;
+using System.Globalization;
+
+namespace Communicate.Tests
+{
+    internal static class Program
+    {
+        private static int Main(string[] args)
+        {
+            var command = args.Length > 0 ? args[0] : "all";
+            var iterations = ReadArgument(args, 1, 1000000);
+            var seed = ReadArgument(args, 2, Environment.TickCount);
+
+            var passed = true;
+            switch (command)
+            {
+                case "fuzz":
+                    passed = ParserFuzzer.Run(iterations, seed);
+                    break;
+                case "benchmark":
+                    ParserFuzzer.Benchmark(iterations);
+                    break;
+                case "parallel":
+                    passed = ParallelTransferBenchmark.Run();
+                    break;
+                case "datagram":
+                    passed = DatagramChannelTest.Run(ReadArgument(args, 1, DatagramChannelTest.DefaultSeed));
+                    break;
+                case "tls":
+                    if (args.Length < 2)
+                    {
+                        Console.WriteLine("Usage: Communicate.Tests tls <certificate.pfx> [password]");
+                        return 2;
+                    }
+                    passed = TlsHandshakeBenchmark.Run(args[1], args.Length > 2 ? args[2] : null);
+                    break;
+                case "fairness":
+                    passed = BandwidthFairnessTest.Run();
+                    break;
+                case "transport":
+                    passed = TransportTest.Run(ReadArgument(args, 1, TransportTest.DefaultSeed));
+                    break;
+                case "registry":
+                    passed = RegistryStressTest.Run(TimeSpan.FromSeconds(ReadArgument(args, 1, 5)), seed);
+                    break;
+                case "all":
+                    passed = ParserFuzzer.Run(iterations, seed);
+                    ParserFuzzer.Benchmark(iterations);
+                    passed &= RegistryStressTest.Run(TimeSpan.FromSeconds(5), seed);
+                    passed &= DatagramChannelTest.Run(DatagramChannelTest.DefaultSeed);
+                    passed &= TransportTest.Run(TransportTest.DefaultSeed);
+                    passed &= BandwidthFairnessTest.Run();
+                    passed &= ParallelTransferBenchmark.Run();
+                    break;
+                default:
+                    Console.WriteLine("Usage: Communicate.Tests [all|fuzz|benchmark] [iterations] [seed]");
+                    Console.WriteLine("       Communicate.Tests registry [seconds] [seed]");
+                    Console.WriteLine("       Communicate.Tests datagram [seed]");
+                    Console.WriteLine("       Communicate.Tests transport [seed]");
+                    Console.WriteLine("       Communicate.Tests parallel");
+                    Console.WriteLine("       Communicate.Tests fairness");
+                    Console.WriteLine("       Communicate.Tests tls <certificate.pfx> [password]");
+                    return 2;
+            }
+
+            Console.WriteLine(passed ? "Passed" : "Failed");
+            return passed ? 0 : 1;
+        }
+
+        private static int ReadArgument(string[] args, int index, int defaultValue)
+        {
+            int value;
+            return args.Length > index && int.TryParse(args[index], NumberStyles.Integer, CultureInfo.InvariantCulture, out value) ? value : defaultValue;
+        }
+    }
+}
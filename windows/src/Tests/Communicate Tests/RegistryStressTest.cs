@@ -0,0 +1,172 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Linq;
+using System.Net;
+using System.Threading;
+
+namespace Communicate.Tests
+{
+    internal static class RegistryStressTest
+    {
+        private const int WriterCount = 4;
+        private const int ConnectionsPerWriter = 64;
+        private const int ClientCount = 8;
+
+        internal static bool Run(TimeSpan duration, int seed)
+        {
+            Console.WriteLine("Stressing the connection registry for {0:F0} s (seed {1})", duration.TotalSeconds, seed);
+            return RunCollectionChurn(duration, seed) && RunCommunicatorChurn(duration, seed);
+        }
+
+        private static bool RunCollectionChurn(TimeSpan duration, int seed)
+        {
+            var connections = new ConnectionCollection();
+            var failures = new List<string>();
+            var stopwatch = Stopwatch.StartNew();
+            long broadcasts = 0;
+            long visited = 0;
+
+            var writers = Enumerable.Range(0, WriterCount).Select(writerIndex => new Thread(() =>
+            {
+                var random = new Random(seed + writerIndex);
+                var owned = new Connection[ConnectionsPerWriter];
+                while (stopwatch.Elapsed < duration)
+                {
+                    var index = random.Next(owned.Length);
+                    if (owned[index] == null)
+                    {
+                        owned[index] = new Connection(new IPEndPoint(IPAddress.Loopback, 1024 + writerIndex*ConnectionsPerWriter + index));
+                        if (!connections.Add(owned[index]))
+                        {
+                            Report(failures, "A new connection could not be added");
+                        }
+                    }
+                    else
+                    {
+                        if (!connections.Remove(owned[index]))
+                        {
+                            Report(failures, "A registered connection could not be removed");
+                        }
+                        owned[index] = null;
+                    }
+                }
+                foreach (var connection in owned.Where(connection => connection != null))
+                {
+                    connections.Remove(connection);
+                }
+            }) { IsBackground = true }).ToList();
+
+            var broadcaster = new Thread(() =>
+            {
+                while (stopwatch.Elapsed < duration)
+                {
+                    var seen = new HashSet<Guid>();
+                    connections.PerformActionOnAll(connection =>
+                    {
+                        if (connection == null || !seen.Add(connection.Identifier))
+                        {
+                            Report(failures, "A broadcast visited a missing or duplicate connection");
+                        }
+                        Interlocked.Increment(ref visited);
+                    });
+                    broadcasts++;
+                }
+            }) { IsBackground = true };
+
+            writers.ForEach(writer => writer.Start());
+            broadcaster.Start();
+            writers.ForEach(writer => writer.Join());
+            broadcaster.Join();
+
+            if (connections.Count != 0)
+            {
+                Report(failures, connections.Count + " connections were left in the registry");
+            }
+            Console.WriteLine("Collection churn: {0} broadcasts visited {1} connections", broadcasts, visited);
+            return Check(failures);
+        }
+
+        private static bool RunCommunicatorChurn(TimeSpan duration, int seed)
+        {
+            var failures = new List<string>();
+            var server = new TestCommunicator(0);
+            var clients = Enumerable.Range(0, ClientCount).Select(index => new TestCommunicator(0)).ToArray();
+            var random = new Random(seed);
+            var stopwatch = Stopwatch.StartNew();
+            long broadcasts = 0;
+            long connects = 0;
+
+            var broadcaster = new Thread(() =>
+            {
+                var payload = new byte[256];
+                while (stopwatch.Elapsed < duration)
+                {
+                    try
+                    {
+                        server.Connections.SendToAll(new CommunicationData().WithData(payload));
+                        broadcasts++;
+                    }
+                    catch (Exception exception)
+                    {
+                        Report(failures, "Broadcasting threw " + exception.GetType().Name + ": " + exception.Message);
+                    }
+                    Thread.Sleep(1);
+                }
+            }) { IsBackground = true };
+            broadcaster.Start();
+
+            while (stopwatch.Elapsed < duration)
+            {
+                var client = clients[random.Next(clients.Length)];
+                if (client.Connections.Count == 0)
+                {
+                    client.ConnectInMemory(server, null);
+                    connects++;
+                }
+                else
+                {
+                    client.Connections.DisconnectAll(true);
+                }
+                Thread.Sleep(random.Next(5));
+            }
+            broadcaster.Join();
+
+            foreach (var client in clients)
+            {
+                client.Connections.DisconnectAll(true);
+            }
+            for (var i = 0; i < 100 && server.Connections.Count > 0; i++)
+            {
+                Thread.Sleep(20);
+            }
+            if (server.Connections.Count != 0)
+            {
+                Report(failures, server.Connections.Count + " server connections were left after every client disconnected");
+            }
+
+            Console.WriteLine("Communicator churn: {0} connects while sending {1} broadcasts", connects, broadcasts);
+            return Check(failures);
+        }
+
+        private static void Report(List<string> failures, string failure)
+        {
+            lock (failures)
+            {
+                failures.Add(failure);
+            }
+        }
+
+        private static bool Check(List<string> failures)
+        {
+            lock (failures)
+            {
+                foreach (var failure in failures.Distinct())
+                {
+                    Console.WriteLine("Failure: " + failure);
+                }
+                return failures.Count == 0;
+            }
+        }
+    }
+}
@@ -0,0 +1,31 @@
+﻿using System.Collections.ObjectModel;
+
+namespace Communicate.Tests
+{
+    internal class TestCommunicator : BaseCommunicator
+    {
+        public TestCommunicator(int port) : base(new CommunicatorInformation(port), new CommunicatorProtocol("Tests"))
+        {
+        }
+
+        protected override void HandlePublish()
+        {
+        }
+
+        protected override void HandleStopPublishing()
+        {
+        }
+
+        protected override void HandleStartSearching()
+        {
+        }
+
+        protected override void HandleStopSearching()
+        {
+        }
+
+        public override Collection<TxtRecord> TxtRecordsFromData(byte[] data) => new Collection<TxtRecord>();
+        public override byte[] DataFromTxtRecords(Collection<TxtRecord> txtRecords) => new byte[0];
+        public override string SerializeProtocolType() => "_tests._tcp";
+    }
+}
@@ -0,0 +1,120 @@
+﻿using System;
+using System.Diagnostics;
+using System.Linq;
+using System.Net;
+using System.Net.Sockets;
+using System.Security.Cryptography.X509Certificates;
+using System.Threading;
+
+namespace Communicate.Tests
+{
+    internal static class TlsHandshakeBenchmark
+    {
+        private const int HandshakeCount = 20;
+        private const string TargetHost = "communicate-tests";
+
+        internal static bool Run(string certificatePath, string password)
+        {
+            X509Certificate2 certificate;
+            try
+            {
+                certificate = new X509Certificate2(certificatePath, password);
+            }
+            catch (System.Security.Cryptography.CryptographicException exception)
+            {
+                Console.WriteLine("Failure: the certificate could not be loaded: " + exception.Message);
+                return false;
+            }
+            if (!certificate.HasPrivateKey)
+            {
+                Console.WriteLine("Failure: the certificate has no private key");
+                return false;
+            }
+
+            Console.WriteLine("Timing {0} TLS handshakes over loopback", HandshakeCount);
+            var serverSettings = new TlsSettings(certificate);
+
+            // The client session cache is keyed by target host, so repeating the host lets later
+            // handshakes resume the first session while a fresh host forces a full handshake each time.
+            var resumable = MeasureHandshakes(serverSettings, index => TargetHost);
+            var full = MeasureHandshakes(serverSettings, index => TargetHost + "-" + index);
+            if (resumable == null || full == null)
+            {
+                return false;
+            }
+
+            var firstHandshake = resumable[0];
+            var resumedHandshake = Median(resumable.Skip(1).ToArray());
+            var fullHandshake = Median(full.Skip(1).ToArray());
+            Console.WriteLine("First handshake:         {0,8:F2} ms", firstHandshake);
+            Console.WriteLine("Repeated host (median):  {0,8:F2} ms", resumedHandshake);
+            Console.WriteLine("Fresh host (median):     {0,8:F2} ms", fullHandshake);
+            Console.WriteLine("A repeated host takes {0:F0}% of the time of a fresh one", 100*resumedHandshake/fullHandshake);
+            return true;
+        }
+
+        private static double[] MeasureHandshakes(TlsSettings serverSettings, Func<int, string> targetHost)
+        {
+            var elapsed = new double[HandshakeCount];
+            var listener = new TcpListener(IPAddress.Loopback, 0);
+            listener.Start();
+            try
+            {
+                for (var i = 0; i < HandshakeCount; i++)
+                {
+                    var clientSettings = new TlsSettings(null, targetHost(i), (sender, certificate, chain, errors) => true);
+                    using (var clientSocket = new Socket(AddressFamily.InterNetwork, SocketType.Stream, ProtocolType.Tcp))
+                    {
+                        clientSocket.Connect((IPEndPoint)listener.LocalEndpoint);
+                        using (var serverSocket = listener.AcceptSocket())
+                        {
+                            Exception serverException = null;
+                            var server = new Thread(() =>
+                            {
+                                try
+                                {
+                                    TlsTransport.Authenticate(new SocketTransport(serverSocket), serverSettings, true);
+                                }
+                                catch (Exception exception)
+                                {
+                                    serverException = exception;
+                                }
+                            }) { IsBackground = true };
+                            server.Start();
+
+                            var stopwatch = Stopwatch.StartNew();
+                            try
+                            {
+                                TlsTransport.Authenticate(new SocketTransport(clientSocket), clientSettings, false);
+                            }
+                            catch (Exception exception)
+                            {
+                                Console.WriteLine("Failure: the client handshake failed: " + exception.Message);
+                                return null;
+                            }
+                            elapsed[i] = stopwatch.Elapsed.TotalMilliseconds;
+
+                            server.Join();
+                            if (serverException != null)
+                            {
+                                Console.WriteLine("Failure: the server handshake failed: " + serverException.Message);
+                                return null;
+                            }
+                        }
+                    }
+                }
+            }
+            finally
+            {
+                listener.Stop();
+            }
+            return elapsed;
+        }
+
+        private static double Median(double[] values)
+        {
+            Array.Sort(values);
+            return values[values.Length/2];
+        }
+    }
+}
@@ -0,0 +1,185 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Net;
+using System.Net.Sockets;
+using System.Threading;
+
+namespace Communicate.Tests
+{
+    internal static class TransportTest
+    {
+        internal const int DefaultSeed = 38;
+
+        private const int MessageCount = 64;
+        private const int MaximumMessageLength = 256*1024;
+        private static readonly TimeSpan Timeout = TimeSpan.FromSeconds(20);
+
+        internal static bool Run(int seed)
+        {
+            Console.WriteLine("Exchanging messages over each transport (seed {0})", seed);
+
+            var conditions = new LinkConditions(seed);
+            conditions.SetLatency(TimeSpan.FromMilliseconds(2));
+            conditions.SetJitter(TimeSpan.FromMilliseconds(2));
+            conditions.SetBandwidthLimit(64*1024*1024);
+
+            var passed = RunExchange("memory", (client, server) => client.ConnectInMemory(server, conditions), seed);
+            passed &= RunExchange("tcp", ConnectOverLoopback, seed);
+            return passed && RunLinkReset(seed);
+        }
+
+        private static void ConnectOverLoopback(BaseCommunicator client, BaseCommunicator server)
+        {
+            var listener = new TcpListener(IPAddress.Loopback, 0);
+            listener.Start();
+            try
+            {
+                var socket = new Socket(AddressFamily.InterNetwork, SocketType.Stream, ProtocolType.Tcp);
+                socket.Connect((IPEndPoint)listener.LocalEndpoint);
+                server.ConnectTo(listener.AcceptSocket(), true);
+                client.ConnectTo(socket, false);
+            }
+            finally
+            {
+                listener.Stop();
+            }
+        }
+
+        private static bool RunExchange(string transportName, Action<BaseCommunicator, BaseCommunicator> connect, int seed)
+        {
+            var failures = new List<string>();
+            var server = new TestCommunicator(0);
+            var client = new TestCommunicator(0);
+
+            var received = new List<byte[]>();
+            var allReceived = new ManualResetEvent(false);
+            server.DidUpdateReceivingData += (communicator, dataArgs) =>
+            {
+                if (dataArgs.Component != DataComponent.All || dataArgs.DataState != ActionState.Completed)
+                {
+                    return;
+                }
+                lock (received)
+                {
+                    received.Add(dataArgs.Data.GetData());
+                    if (received.Count == MessageCount)
+                    {
+                        allReceived.Set();
+                    }
+                }
+            };
+
+            connect(client, server);
+            var connection = WaitForConnection(client);
+            if (connection == null || WaitForConnection(server) == null)
+            {
+                failures.Add(transportName + ": the connection was not established");
+                return Check(failures);
+            }
+
+            var random = new Random(seed);
+            var sent = new List<byte[]>();
+            for (var i = 0; i < MessageCount; i++)
+            {
+                var content = new byte[random.Next(1, MaximumMessageLength)];
+                random.NextBytes(content);
+                sent.Add(content);
+
+                var messageSent = new ManualResetEvent(false);
+                var data = new CommunicationData().WithData(content);
+                EventHandler<ConnectionEventArgs> handler = (communicator, dataArgs) =>
+                {
+                    if (dataArgs.Data == data && dataArgs.Component == DataComponent.All && dataArgs.DataState == ActionState.Completed)
+                    {
+                        messageSent.Set();
+                    }
+                };
+                client.DidUpdateSendingData += handler;
+                connection.Send(data);
+                messageSent.WaitOne(Timeout);
+                client.DidUpdateSendingData -= handler;
+            }
+
+            if (!allReceived.WaitOne(Timeout))
+            {
+                failures.Add(transportName + ": only " + received.Count + " of " + MessageCount + " messages were received");
+            }
+            lock (received)
+            {
+                if (received.Count == MessageCount && !received.Zip(sent, (first, second) => first.SequenceEqual(second)).All(equal => equal))
+                {
+                    failures.Add(transportName + ": the received messages do not match the sent messages");
+                }
+            }
+
+            client.Connections.DisconnectAll(true);
+            server.Connections.DisconnectAll(true);
+            Console.WriteLine("{0}: {1} of {2} messages received", transportName, received.Count, MessageCount);
+            return Check(failures);
+        }
+
+        private static bool RunLinkReset(int seed)
+        {
+            var failures = new List<string>();
+            var server = new TestCommunicator(0);
+            var client = new TestCommunicator(0);
+
+            var disconnectedConnections = new HashSet<Connection>();
+            var disconnected = new ManualResetEvent(false);
+            EventHandler<ConnectionEventArgs> handler = (communicator, connectionArgs) =>
+            {
+                if (connectionArgs.ActiveConnection.State != ConnectionState.Disconnected)
+                {
+                    return;
+                }
+                lock (disconnectedConnections)
+                {
+                    if (disconnectedConnections.Add(connectionArgs.ActiveConnection) && disconnectedConnections.Count == 2)
+                    {
+                        disconnected.Set();
+                    }
+                }
+            };
+            server.DidUpdateConnectionState += handler;
+            client.DidUpdateConnectionState += handler;
+
+            var conditions = new LinkConditions(seed);
+            conditions.SetResetProbabilityPerSend(1);
+            client.ConnectInMemory(server, conditions);
+            WaitForConnection(client)?.Send(new CommunicationData().WithData(new byte[16]));
+
+            if (!disconnected.WaitOne(Timeout))
+            {
+                failures.Add("memory: a link that resets on every send was still connected");
+            }
+
+            Console.WriteLine("memory: link reset on the first send");
+            return Check(failures);
+        }
+
+        private static Connection WaitForConnection(BaseCommunicator communicator)
+        {
+            var deadline = DateTime.UtcNow + Timeout;
+            while (DateTime.UtcNow < deadline)
+            {
+                var connection = communicator.Connections.ToSnapshot().FirstOrDefault(candidate => candidate.State == ConnectionState.Connected);
+                if (connection != null)
+                {
+                    return connection;
+                }
+                Thread.Sleep(10);
+            }
+            return null;
+        }
+
+        private static bool Check(List<string> failures)
+        {
+            foreach (var failure in failures)
+            {
+                Console.WriteLine("Failure: " + failure);
+            }
+            return failures.Count == 0;
+        }
+    }
+}